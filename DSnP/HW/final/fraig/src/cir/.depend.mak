@@ -1,34 +1,52 @@
-cirGate.o: cirGate.cpp cirGate.h cirDef.h ../../include/myHashMap.h \
- ../../include/sat.h ../../include/Solver.h ../../include/SolverTypes.h \
+cirCmd.o: cirCmd.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirSimWord.h cirSimView.h cirMemMgr.h cirStrash.h cirThreadPool.h \
+ cirGate.h ../../include/sat.h ../../include/Solver.h \
+ ../../include/SolverTypes.h ../../include/Global.h \
+ ../../include/VarOrder.h ../../include/Heap.h ../../include/Proof.h \
+ ../../include/File.h cirCmd.h ../../include/cmdParser.h \
+ ../../include/cmdCharDef.h ../../include/util.h ../../include/rnGen.h \
+ ../../include/myUsage.h
+cirCut.o: cirCut.cpp cirCut.h cirDef.h ../../include/myHashMap.h \
+ cirSimWord.h cirGate.h cirMemMgr.h ../../include/sat.h \
+ ../../include/Solver.h ../../include/SolverTypes.h \
  ../../include/Global.h ../../include/VarOrder.h ../../include/Heap.h \
- ../../include/Proof.h ../../include/File.h cirMgr.h ../../include/util.h \
- ../../include/rnGen.h ../../include/myUsage.h
-cirMgr.o: cirMgr.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ ../../include/Proof.h ../../include/File.h
+cirFraig.o: cirFraig.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirSimWord.h cirSimView.h cirMemMgr.h cirStrash.h cirThreadPool.h \
  cirGate.h ../../include/sat.h ../../include/Solver.h \
  ../../include/SolverTypes.h ../../include/Global.h \
  ../../include/VarOrder.h ../../include/Heap.h ../../include/Proof.h \
  ../../include/File.h ../../include/util.h ../../include/rnGen.h \
  ../../include/myUsage.h
-cirSim.o: cirSim.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+cirGate.o: cirGate.cpp cirGate.h cirDef.h ../../include/myHashMap.h \
+ cirSimWord.h cirMemMgr.h ../../include/sat.h ../../include/Solver.h \
+ ../../include/SolverTypes.h ../../include/Global.h \
+ ../../include/VarOrder.h ../../include/Heap.h ../../include/Proof.h \
+ ../../include/File.h cirMgr.h cirSimView.h cirStrash.h cirThreadPool.h \
+ ../../include/util.h ../../include/rnGen.h ../../include/myUsage.h
+cirMgr.o: cirMgr.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirSimWord.h cirSimView.h cirMemMgr.h cirStrash.h cirThreadPool.h \
  cirGate.h ../../include/sat.h ../../include/Solver.h \
  ../../include/SolverTypes.h ../../include/Global.h \
  ../../include/VarOrder.h ../../include/Heap.h ../../include/Proof.h \
  ../../include/File.h ../../include/util.h ../../include/rnGen.h \
  ../../include/myUsage.h
-cirFraig.o: cirFraig.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+cirOpt.o: cirOpt.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirSimWord.h cirSimView.h cirMemMgr.h cirStrash.h cirThreadPool.h \
  cirGate.h ../../include/sat.h ../../include/Solver.h \
  ../../include/SolverTypes.h ../../include/Global.h \
  ../../include/VarOrder.h ../../include/Heap.h ../../include/Proof.h \
  ../../include/File.h ../../include/util.h ../../include/rnGen.h \
  ../../include/myUsage.h
-cirCmd.o: cirCmd.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+cirRewrite.o: cirRewrite.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirSimWord.h cirSimView.h cirMemMgr.h cirStrash.h cirThreadPool.h \
  cirGate.h ../../include/sat.h ../../include/Solver.h \
  ../../include/SolverTypes.h ../../include/Global.h \
  ../../include/VarOrder.h ../../include/Heap.h ../../include/Proof.h \
- ../../include/File.h cirCmd.h ../../include/cmdParser.h \
- ../../include/cmdCharDef.h ../../include/util.h ../../include/rnGen.h \
+ ../../include/File.h cirCut.h ../../include/util.h ../../include/rnGen.h \
  ../../include/myUsage.h
-cirOpt.o: cirOpt.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+cirSim.o: cirSim.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirSimWord.h cirSimView.h cirMemMgr.h cirStrash.h cirThreadPool.h \
  cirGate.h ../../include/sat.h ../../include/Solver.h \
  ../../include/SolverTypes.h ../../include/Global.h \
  ../../include/VarOrder.h ../../include/Heap.h ../../include/Proof.h \
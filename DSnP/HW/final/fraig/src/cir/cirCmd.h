@@ -17,6 +17,8 @@ CmdClass(CirGateCmd);
 CmdClass(CirSweepCmd);
 CmdClass(CirOptCmd);
 CmdClass(CirStrashCmd);
+CmdClass(CirRewriteCmd);
+CmdClass(CirBalanceCmd);
 CmdClass(CirSimCmd);
 CmdClass(CirFraigCmd);
 CmdClass(CirWriteCmd);
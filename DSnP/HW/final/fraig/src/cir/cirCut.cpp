@@ -0,0 +1,186 @@
+/****************************************************************************
+  FileName     [ cirCut.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define k-feasible cut enumeration ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <cassert>
+#include <algorithm>
+#include "cirCut.h"
+#include "cirGate.h"
+
+using namespace std;
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+static const unsigned long long varMask[CIR_CUT_MAX] = {
+   0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+   0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+};
+
+// Exchange variables i < j of a truth table
+static inline unsigned long long
+swapVars(unsigned long long t, int i, int j)
+{
+   unsigned long long m = varMask[i] & ~varMask[j];   // xi = 1, xj = 0
+   int s = (1 << j) - (1 << i);
+   return (t & ~(m | (m << s))) | ((t & m) << s) | ((t >> s) & m);
+}
+
+// The truth table of "a" over the leaves of "c", which contain a's leaves.
+// Leaf i of "a" moves to its place in "c" from the last one down, so it
+// always moves onto a variable the table does not depend on.
+static unsigned long long
+stretchTT(const CirCut& a, const CirCut& c)
+{
+   unsigned long long t = a._tt;
+   for(int i = int(a._size) - 1, j = int(c._size) - 1; i >= 0; --i)
+   {
+      while(c._leaf[j] != a._leaf[i]) --j;
+      if(j != i) t = swapVars(t, i, j);
+   }
+   return t;
+}
+
+// true if the leaves of a are a subset of the leaves of b
+static bool
+dominates(const CirCut& a, const CirCut& b)
+{
+   if(a._size > b._size || (a._sign & ~b._sign)) return false;
+   for(unsigned i = 0, j = 0; i < a._size; ++i, ++j)
+   {
+      while(j < b._size && b._leaf[j] < a._leaf[i]) ++j;
+      if(j == b._size || b._leaf[j] != a._leaf[i]) return false;
+   }
+   return true;
+}
+
+static bool
+cutSizeLess(const CirCut& a, const CirCut& b) { return a._size < b._size; }
+
+/**************************************/
+/*   class CirCutMgr member functions */
+/**************************************/
+CirCut
+CirCutMgr::trivialCut(unsigned id)
+{
+   CirCut c;
+   c._tt = varMask[0]; c._sign = 1u << (id % 32);
+   c._size = 1; c._leaf[0] = id;
+   return c;
+}
+
+void
+CirCutMgr::compute(const CirGate* g)
+{
+   assert(g->isAig());
+   unsigned id = g->getId();
+   if(id >= _start.size()) init(id);
+   for(int i = 0; i < 2; ++i)
+   {
+      unsigned in = g->getIn(i)->getId();
+      _in[i].assign(1, trivialCut(in));
+      for(size_t j = 0; j < numCuts(in); ++j) _in[i].push_back(cut(in, j));
+   }
+   _res.clear();
+   for(size_t i = 0; i < _in[0].size(); ++i)
+      for(size_t j = 0; j < _in[1].size(); ++j)
+      {
+         CirCut c;
+         if(!merge(_in[0][i], _in[1][j], c)) continue;
+         bool dominated = false;
+         for(size_t r = 0; r < _res.size() && !dominated; ++r) dominated = dominates(_res[r], c);
+         if(dominated) continue;
+         size_t n = 0;
+         for(size_t r = 0; r < _res.size(); ++r) if(!dominates(c, _res[r])) _res[n++] = _res[r];
+         _res.resize(n);
+         unsigned long long t0 = stretchTT(_in[0][i], c), t1 = stretchTT(_in[1][j], c);
+         if(g->fanin_inv(0)) t0 = ~t0;
+         if(g->fanin_inv(1)) t1 = ~t1;
+         c._tt = t0 & t1;
+         _res.push_back(c);
+      }
+   stable_sort(_res.begin(), _res.end(), cutSizeLess);
+   if(_res.size() > _limit) _res.resize(_limit);
+
+   release(id);
+   _start[id] = alloc(_res.size());
+   _num[id] = _res.size();
+   copy(_res.begin(), _res.end(), _pool.begin() + _start[id]);
+   _done[id] = true;
+   if(!_drop) return;
+   _ref[id] = pending(g);
+   // the count may miss fanouts added since, so it is only trusted when it
+   // says there are some left
+   for(int i = 0; i < 2; ++i)
+   {
+      const CirGate* in = g->getIn(i);
+      if(!hasCuts(in->getId()) || (_ref[in->getId()] && --_ref[in->getId()])) continue;
+      if(!(_ref[in->getId()] = pending(in))) release(in->getId());
+   }
+}
+
+void
+CirCutMgr::compute(const GateList& gates, const IdList& order)
+{
+   for(size_t i = 0; i < order.size(); ++i)
+      if(gates[order[i]] && gates[order[i]]->isAig()) compute(gates[order[i]]);
+}
+
+void
+CirCutMgr::release(unsigned id)
+{
+   if(!hasCuts(id)) return;
+   if(_num[id] >= _free.size()) _free.resize(_num[id] + 1);
+   _free[_num[id]].push_back(_start[id]);
+   _start[id] = NONE; _num[id] = 0;
+}
+
+// AIG fanouts of "g" whose cuts have never been computed
+unsigned
+CirCutMgr::pending(const CirGate* g) const
+{
+   unsigned n = 0;
+   for(size_t i = 0; i < g->getOutSize(); ++i)
+   {
+      const CirGate* out = g->getOut(i);
+      if(out->isAig() && (out->getId() >= _done.size() || !_done[out->getId()])) ++n;
+   }
+   return n;
+}
+
+// Merge the sorted leaves of a and b into c; false if there are more than k
+bool
+CirCutMgr::merge(const CirCut& a, const CirCut& b, CirCut& c) const
+{
+   c._sign = a._sign | b._sign;
+   if(unsigned(__builtin_popcount(c._sign)) > _k) return false;
+   unsigned i = 0, j = 0, n = 0;
+   while(i < a._size || j < b._size)
+   {
+      if(n == _k) return false;
+      if(j == b._size || (i < a._size && a._leaf[i] < b._leaf[j])) c._leaf[n++] = a._leaf[i++];
+      else if(i == a._size || b._leaf[j] < a._leaf[i]) c._leaf[n++] = b._leaf[j++];
+      else { c._leaf[n++] = a._leaf[i++]; ++j; }
+   }
+   c._size = n;
+   return true;
+}
+
+// A block of n cuts, recycled if one has been released
+unsigned
+CirCutMgr::alloc(unsigned n)
+{
+   if(n < _free.size() && !_free[n].empty())
+   {
+      unsigned s = _free[n].back();
+      _free[n].pop_back();
+      return s;
+   }
+   unsigned s = _pool.size();
+   _pool.resize(s + n);
+   return s;
+}
@@ -0,0 +1,99 @@
+/****************************************************************************
+  FileName     [ cirCut.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define k-feasible cuts of AIG gates and their manager ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_CUT_H
+#define CIR_CUT_H
+
+#include <vector>
+#include <climits>
+#include <cassert>
+#include "cirDef.h"
+
+using namespace std;
+
+#define CIR_CUT_MAX  6     // at most 6 leaves, so a truth table fits in 64 bits
+
+//------------------------------------------------------------------------
+//   CirCut
+//------------------------------------------------------------------------
+// Sorted leaf ids and the function of the gate over them: leaf i is
+// variable i of _tt, and _tt does not depend on the variables >= _size.
+// _sign has bit (id % 32) set for every leaf, to rule out most subset and
+// merge checks without looking at the leaves.
+struct CirCut
+{
+   unsigned long long   _tt;
+   unsigned             _sign;
+   unsigned             _size;
+   unsigned             _leaf[CIR_CUT_MAX];
+
+   // the truth table of the first 4 variables, for cuts of at most 4 leaves
+   unsigned short tt16() const { return (unsigned short)_tt; }
+};
+
+//------------------------------------------------------------------------
+//   CirCutMgr
+//------------------------------------------------------------------------
+// Bottom-up enumeration of the k-feasible cuts of AIG gates, by gate id.
+// The cuts of a gate are merged from those of its fanins plus the fanins
+// themselves (trivial cuts); a cut that contains another one is dropped,
+// and the smallest "limit" cuts are kept.
+// A gate's cuts are one block of a shared pool; blocks are recycled by
+// cut count, like the fanout arrays in CirMemMgr. With "drop", the cuts of
+// a gate are released once all its AIG fanouts have taken theirs from
+// them, so a pass in _dfsList order only keeps the cuts of its frontier.
+// A fanin without cuts (released, or not an AIG) only gives its trivial
+// cut. References returned by cut() are valid until the next compute().
+//
+class CirCutMgr
+{
+public:
+   CirCutMgr(unsigned k = 4, unsigned limit = 8, bool drop = false) : _k(k), _limit(limit), _drop(drop) {
+      assert(k >= 2 && k <= CIR_CUT_MAX && limit > 0);
+   }
+
+   // for gate ids 0 ~ maxId; may be called again as gates are added
+   void init(size_t maxId) {
+      _start.resize(maxId + 1, NONE); _num.resize(maxId + 1, 0);
+      _ref.resize(maxId + 1, 0); _done.resize(maxId + 1, false);
+   }
+   void clear() { _start.clear(); _num.clear(); _ref.clear(); _done.clear(); _pool.clear(); _free.clear(); }
+
+   unsigned k() const { return _k; }
+   bool hasCuts(unsigned id) const { return id < _start.size() && _start[id] != NONE; }
+   size_t numCuts(unsigned id) const { return hasCuts(id)? _num[id] : 0; }
+   const CirCut& cut(unsigned id, size_t i) const { assert(i < numCuts(id)); return _pool[_start[id] + i]; }
+
+   // (Re)compute the cuts of the AIG "g" from the cuts of its fanins
+   void compute(const CirGate* g);
+   // compute() every AIG of a topological list of gate ids
+   void compute(const GateList& gates, const IdList& order);
+   void release(unsigned id);
+
+   static CirCut trivialCut(unsigned id);
+
+private:
+   enum { NONE = UINT_MAX };
+   unsigned             _k;
+   unsigned             _limit;
+   bool                 _drop;
+   vector<unsigned>     _start;     // by gate id: first cut in _pool
+   vector<unsigned>     _num;       // by gate id: number of cuts
+   vector<unsigned>     _ref;       // by gate id: AIG fanouts yet to compute
+   vector<bool>         _done;      // by gate id: cuts have been computed
+   vector<CirCut>       _pool;
+   vector<IdList>       _free;      // _free[n]: released blocks of n cuts
+   vector<CirCut>       _in[2];     // scratch for compute()
+   vector<CirCut>       _res;
+
+   bool merge(const CirCut& a, const CirCut& b, CirCut& c) const;
+   unsigned alloc(unsigned n);
+   unsigned pending(const CirGate* g) const;
+};
+
+#endif // CIR_CUT_H
@@ -11,6 +11,7 @@
 
 #include <vector>
 #include "myHashMap.h"
+#include "cirSimWord.h"
 
 using namespace std;
 
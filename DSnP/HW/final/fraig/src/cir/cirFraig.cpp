@@ -7,10 +7,11 @@
 ****************************************************************************/
 
 #include <cassert>
+#include <climits>
+#include <algorithm>
 #include "cirMgr.h"
 #include "cirGate.h"
 #include "sat.h"
-#include "myHashMap.h"
 #include "util.h"
 
 using namespace std;
@@ -25,36 +26,271 @@ using namespace std;
 /**************************************/
 /*   Static varaibles and functions   */
 /**************************************/
+// Variables are created lazily, one per view index (-1 = not encoded yet).
+// CONST 0 (and undefined fanins) is asserted false.
+static void
+initProofModel(const CirSimView& view, SatSolver& solver, vector<Var>& vars)
+{
+   vars.assign(view.size(), -1);
+   vars[0] = solver.newVar();
+   solver.assertProperty(vars[0], false);
+}
+
+// Encode the transitive fanin cone of "idx" that is not in the solver yet,
+// so only the cones of the pairs actually proved are ever added
+static Var
+encodeCone(const CirSimView& view, SatSolver& solver, vector<Var>& vars, unsigned idx)
+{
+   if(vars[idx] >= 0) return vars[idx];
+   vector<unsigned> stack(1, idx);
+   while(!stack.empty())
+   {
+      unsigned i = stack.back();
+      if(vars[i] >= 0) { stack.pop_back(); continue; }
+      if(i < view.firstAig()) { vars[i] = solver.newVar(); stack.pop_back(); continue; }
+      unsigned l0 = view.fanin0(i), l1 = view.fanin1(i);
+      if(vars[l0 >> 1] < 0) { stack.push_back(l0 >> 1); continue; }
+      if(vars[l1 >> 1] < 0) { stack.push_back(l1 >> 1); continue; }
+      vars[i] = solver.newVar();
+      solver.addAigCNF(vars[i], vars[l0 >> 1], l0 & 1, vars[l1 >> 1], l1 & 1);
+      stack.pop_back();
+   }
+   return vars[idx];
+}
+
+// Store the PI values of the last SAT model as pattern "k" of cex;
+// PIs outside the encoded cones do not matter and stay 0
+static void
+recordCex(const SatSolver& solver, const vector<Var>& vars, vector<SimWord>& cex, size_t k)
+{
+   for(size_t i = 0, n = cex.size(); i < n; ++i)
+      if(vars[i + 1] >= 0 && solver.getValue(vars[i + 1]) == 1) cex[i].setBit(k);
+}
+
+// Prove a == b (or a == !b if inv) by showing that a != b is UNSAT.
+// Return 1 if proved, 0 if disproved (the model is a counter-example)
+// and -1 if the solver ran out of its conflict budget.
+static int
+proveEqual(SatSolver& solver, Var a, Var b, bool inv)
+{
+   Var f = solver.newVar();
+   solver.addXorCNF(f, a, false, b, inv);
+   solver.assumeRelease();
+   solver.assumeProperty(f, true);
+   if(solver.assumpSolve()) return 0;
+   return (solver.budgetOut())? -1 : 1;
+}
+
+// One SAT solver with its own lazily encoded CNF. In each round a worker
+// proves its share of the candidates, in topological order, until all but
+// the last pattern of its counter-example word are used; it only reads the
+// view, so the workers of a round can run in parallel.
+class FraigWorker
+{
+public:
+   FraigWorker() : _nCex(0) {}
+
+   void init(const CirSimView& view, int budget) {
+      _solver.initialize();
+      _solver.setConflictBudget(budget);
+      initProofModel(view, _solver, _vars);
+      _cex.assign(view.numPi(), SimWord());
+   }
+   // "repOf" as in CirMgr::fraig(); "cands" are view indices in increasing order
+   void prove(const CirSimView& view, const vector<unsigned>& repOf) {
+      _proved.clear(); _unknown.clear();
+      for(size_t i = 0, n = _cands.size(); i < n && _nCex < SimWord::BITS - 1; ++i)
+      {
+         unsigned idx = _cands[i];
+         Var repVar = encodeCone(view, _solver, _vars, repOf[idx] >> 1);
+         Var v = encodeCone(view, _solver, _vars, idx);
+         int result = proveEqual(_solver, repVar, v, repOf[idx] & 1);
+         if(result == 1) _proved.push_back(idx);
+         else if(result == 0) recordCex(_solver, _vars, _cex, _nCex++);
+         else _unknown.push_back(idx);
+      }
+   }
+
+   IdList            _cands;     // candidates of this round
+   IdList            _proved;    // results of this round
+   IdList            _unknown;
+   vector<SimWord>   _cex;       // one word per PI
+   size_t            _nCex;
+
+private:
+   SatSolver         _solver;
+   vector<Var>       _vars;
+};
 
 /*******************************************/
 /*   Public member functions about fraig   */
 /*******************************************/
 // _floatList may be changed.
 // _unusedList and _undefList won't be changed
+// _strash survives the command: a gate is merged into the one in the table
+// if that one has been visited (so precedes it in _dfsList), otherwise it
+// takes over the entry.
 void
 CirMgr::strash()
 {
-	HashMap<HashKey, size_t> hash(_dfsList.size());
+	if(_strash.empty()) _strash.init(_dfsList.size());
+	CirGate::resetMark();
 	for(size_t i = 0; i < _dfsList.size(); ++i)
 	{
-		size_t  mergeGate;
-		HashKey k((size_t)sorted_list[_dfsList[i]]->getIn(0), (size_t)sorted_list[_dfsList[i]]->getIn(1), sorted_list[_dfsList[i]]->fanin_inv(0), sorted_list[_dfsList[i]]->fanin_inv(1));
-		if(hash.query(k, mergeGate))
-		{
-			sorted_list[_dfsList[i]]->merge(sorted_list[mergeGate]);
-			sorted_list[_dfsList[i]] = 0;
-		}
-		else hash.insert(k, _dfsList[i]);
+		CirGate* g = sorted_list[_dfsList[i]];
+		if(!g) continue;
+		unsigned lit0 = g->getInLit(0), lit1 = g->getInLit(1), rep;
+		if(_strash.query(lit0, lit1, rep) && rep != g->getId() && sorted_list[rep] && sorted_list[rep]->is_marked())
+			mergeGate(g, sorted_list[rep], false, "Strashing");
+		else { _strash.replace(lit0, lit1, g->getId()); g->mark(); }
 	}
-	updateDfsList();
+	compactDfsList();
 }
 
 
+// Enter the AIGs of _dfsList into _strash if it has not been built by
+// strash() yet; duplicates are not merged, the first one keeps the entry
+void
+CirMgr::fillStrash()
+{
+	if(!_strash.empty()) return;
+	_strash.init(_dfsList.size());
+	for(size_t i = 0; i < _dfsList.size(); ++i)
+	{
+		CirGate* g = sorted_list[_dfsList[i]];
+		_strash.insert(g->getInLit(0), g->getInLit(1), g->getId());
+	}
+}
+
+// Prove the FEC groups from simulation with _fraigThreads SAT solvers.
+// Each group is represented by its topologically first member (smallest
+// view index), so merging never creates a loop.
+// Candidates are proved in topological order, so learnt clauses about the
+// fanin cones of later pairs are reused. Each proof gets at most
+// _fraigBudget conflicts; the pairs beyond that are left unmerged and
+// reported at the end.
+// The models of disproved pairs are collected into one SimWord per PI and
+// resimulated together once all but the last pattern of the word are used,
+// which usually splits many other groups as well and saves their SAT calls.
+// Groups are dealt out to the workers round-robin and the merges are
+// applied after each round in topological order. The workers and their
+// solvers are kept for all rounds and run on _pool. A candidate can only be
+// merged into the first gate of its equivalence class, so the result does
+// not depend on the number of threads (unless some proof runs out of its
+// budget).
 void
 CirMgr::fraig()
 {
+   if(_fecGrps.empty()) return;
+   _pool.resize(_fraigThreads);
+   vector<FraigWorker> workers(_pool.size());
+   for(size_t t = 0; t < workers.size(); ++t) workers[t].init(_simView, _fraigBudget);
+   vector<bool> done(sorted_list.size(), false);
+   IdList unknown;   // pairs of (rep lit, candidate lit) in gate ids
+   // (rep index << 1 | phase difference) of each candidate index; only the
+   // entries of the current candidates are set, and they are reset after
+   // each round
+   vector<unsigned> repOf(_simView.size(), UINT_MAX), workerOf(_simView.size(), 0);
+   IdList cands;
+
+   while(!_fecGrps.empty())
+   {
+      cands.clear();
+      for(size_t i = 0, n = _fecGrps.size(); i < n; ++i)
+      {
+         const IdList& grp = _fecGrps[i];
+         size_t rep = 0;
+         for(size_t j = 1; j < grp.size(); ++j)
+            if(_simView.index(grp[j] >> 1) < _simView.index(grp[rep] >> 1)) rep = j;
+         for(size_t j = 0; j < grp.size(); ++j)
+         {
+            if(j == rep) continue;
+            unsigned idx = _simView.index(grp[j] >> 1);
+            repOf[idx] = (_simView.index(grp[rep] >> 1) << 1) | ((grp[j] ^ grp[rep]) & 1);
+            workerOf[idx] = i % workers.size();
+            cands.push_back(idx);
+         }
+      }
+      sort(cands.begin(), cands.end());
+      for(size_t t = 0; t < workers.size(); ++t) workers[t]._cands.clear();
+      for(size_t i = 0, n = cands.size(); i < n; ++i)
+         workers[workerOf[cands[i]]]._cands.push_back(cands[i]);
+
+      _pool.run([&](size_t t) { workers[t].prove(_simView, repOf); });
+
+      IdList proved;
+      for(size_t t = 0; t < workers.size(); ++t)
+      {
+         proved.insert(proved.end(), workers[t]._proved.begin(), workers[t]._proved.end());
+         for(size_t i = 0, n = workers[t]._unknown.size(); i < n; ++i)
+         {
+            unsigned idx = workers[t]._unknown[i];
+            unknown.push_back(_simView.gateId(repOf[idx] >> 1) << 1);
+            unknown.push_back((_simView.gateId(idx) << 1) | (repOf[idx] & 1));
+            done[_simView.gateId(idx)] = true;
+         }
+      }
+      sort(proved.begin(), proved.end());
+      for(size_t i = 0, n = proved.size(); i < n; ++i)
+      {
+         unsigned id = _simView.gateId(proved[i]);
+         mergeGate(sorted_list[id], sorted_list[_simView.gateId(repOf[proved[i]] >> 1)], repOf[proved[i]] & 1, "Fraig");
+         done[id] = true;
+      }
+      removeFEC(done);
+      for(size_t i = 0, n = cands.size(); i < n; ++i) repOf[cands[i]] = UINT_MAX;
+
+      bool resim = false;
+      for(size_t t = 0; t < workers.size(); ++t)
+      {
+         vector<SimWord>& cex = workers[t]._cex;
+         size_t nCex = workers[t]._nCex;
+         if(nCex == 0) continue;
+         // The other patterns (at least the last one) keep the last simulated
+         // values, which all groups agree with; without them the new values
+         // could not tell a == b from a == !b, and a disproved pair would
+         // only come back with its phase flipped.
+         for(size_t i = 0, n = cex.size(); i < n; ++i)
+         {
+            SimWord& w = _simView.piValue(i);
+            for(size_t k = 0; k < SimWord::WORDS; ++k)
+            {
+               size_t m = (nCex >= (k + 1) * 64)? ~size_t(0) : (nCex <= k * 64)? 0 : (size_t(1) << (nCex - k * 64)) - 1;
+               w[k] = (w[k] & ~m) | cex[i][k];
+            }
+            cex[i] = SimWord();
+         }
+         workers[t]._nCex = 0;
+         _simView.simulate();
+         refineFEC(&_simView.value(0));
+         resim = true;
+      }
+      if(resim) cout << "Updating by SAT... Total #FEC Group = " << _fecGrps.size() << endl;
+   }
+   if(unknown.size())
+   {
+      cout << unknown.size() / 2 << " pair(s) unresolved within " << _fraigBudget << " conflicts, left unmerged:" << endl;
+      for(size_t i = 0, n = unknown.size(); i < n; i += 2)
+         cout << "  (" << (unknown[i] >> 1) << ", " << ((unknown[i + 1] & 1)? "!" : "") << (unknown[i + 1] >> 1) << ")" << endl;
+   }
+   compactDfsList();
 }
 
 /********************************************/
 /*   Private member functions about fraig   */
 /********************************************/
+// Drop the members marked in "done" (indexed by gate id) and the groups
+// left with one member
+void
+CirMgr::removeFEC(const vector<bool>& done)
+{
+   vector<IdList> newGrps;
+   for(size_t i = 0, n = _fecGrps.size(); i < n; ++i)
+   {
+      IdList grp;
+      for(size_t j = 0, m = _fecGrps[i].size(); j < m; ++j)
+         if(!done[_fecGrps[i][j] >> 1]) grp.push_back(_fecGrps[i][j]);
+      if(grp.size() > 1) { newGrps.push_back(IdList()); newGrps.back().swap(grp); }
+   }
+   _fecGrps.swap(newGrps);
+}
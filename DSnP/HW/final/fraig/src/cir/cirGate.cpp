@@ -23,100 +23,100 @@ using namespace std;
 
 extern CirMgr *cirMgr;
 
-bool out_comp(CirGate* & a, CirGate* & b)
+// fanout entries carry the inverted flag in bit 0; a strict order on the ids
+bool out_comp(CirGate* const& a, CirGate* const& b)
 {
-	if(a->getId() <= b->getId()) return true;
+	if(((CirGate*)(size_t(a) & ~size_t(1)))->getId() < ((CirGate*)(size_t(b) & ~size_t(1)))->getId()) return true;
 	else return false;
 }
 
 /**************************************/
 /*   class CirGate member functions   */
 /**************************************/
+// Replace this gate by "gate" (inverted if inv) in all its fanouts and
+// detach it from its fanins; the caller removes it from the circuit.
+// "op" is the prefix of the report, e.g. "Strashing" or "Fraig".
 void
-CirGate::merge(CirGate* gate)
+CirGate::merge(CirGate* gate, bool inv, const string& op, CirMemMgr& m)
 {
    for(size_t i = 0; i < _fanout.size(); ++i)
    {
-      gate->setOutGate(getOut(i), fanout_inv(i));
-      getOut(i)->setInGate(getOut(i)->findIn(getId()), gate, fanout_inv(i));
+      gate->setOutGate(getOut(i), fanout_inv(i) != inv, m);
+      getOut(i)->setInGate(getOut(i)->findIn(getId()), gate, fanout_inv(i) != inv);
    }
-   _fanout.clear();
-   cout << "Strashing: " << gate->getId() << " merging " << getId() << "..." << endl;
+   _fanout.clear(m);
+   for(int i = 0; i < 2; ++i) if(getIn(i)) getIn(i)->removeOut(getId());
+   cout << op << ": " << gate->getId() << " merging " << (inv? "!" : "") << getId() << "..." << endl;
 }
 
 int CirGate::_state = 1;
+// The dfs functions use explicit stacks, so the logic depth is not bounded
+// by the call stack. A gate is marked when it is pushed; in an acyclic
+// netlist this visits the gates in the same order as the recursion did,
+// and a combinational loop in a bad file is cut instead of looping forever.
 void
 CirGate::dfs(size_t& num) const
 {
-   if(getTypeInt() == UNDEF_GATE) return;
-   for(int i = 0; i < 2; ++i) { if(!getIn(i)) continue; if(!getIn(i)->is_marked()) getIn(i)->dfs(num); }
-   cout << "[" << num << "] " << setw(4) << left << getTypeStr() << getId();
-   if(getTypeInt() == AIG_GATE || getTypeInt() == PO_GATE)
-   {
-      for(int i = 0; i < 2; ++i)
+   postOrder([&num](const CirGate* g) {
+      cout << "[" << num << "] " << setw(4) << left << g->getTypeStr() << g->getId();
+      if(g->getTypeInt() == AIG_GATE || g->getTypeInt() == PO_GATE)
       {
-         if(!getIn(i)) continue; 
-         cout << " ";
-         if(getIn(i)->getTypeInt() == UNDEF_GATE) cout << "*";
-         if(fanin_inv(i)) cout << "!";
-         cout << getIn(i)->getId();
+         for(int i = 0; i < 2; ++i)
+         {
+            if(!g->getIn(i)) continue;
+            cout << " ";
+            if(g->getIn(i)->getTypeInt() == UNDEF_GATE) cout << "*";
+            if(g->fanin_inv(i)) cout << "!";
+            cout << g->getIn(i)->getId();
+         }
       }
-   }
-   if(getSymbol().size()) cout << " (" << getSymbol() << ")";
-   cout << endl;
-   mark();
-   ++num;
+      if(g->getSymbol().size()) cout << " (" << g->getSymbol() << ")";
+      cout << endl;
+      ++num;
+   });
 }
-void
-CirGate::dfs(bool in, int level, int searched_level) const
+
+// Print "g" as a line of the fanin/fanout report at depth "searched_level";
+// return true if its fanins/fanouts are to be listed below it
+static bool
+reportLine(const CirGate* g, bool in, int level, int searched_level)
 {
-   cout << getTypeStr() << " " << getId();
-   // if(is_marked() && searched_level != level && getTypeInt() != PI_GATE && getTypeInt() != CONST_GATE) { cout << " (*)" << endl; return; }
-   // else cout << endl;
-   int count = 0;
-   bool no_dfs = false;
-   if(in)
-      for(int i = 0; i < 2; ++i)
-      {
-         if(!getIn(i)) continue;
-         ++count;
-      }
-   else count = _fanout.size();
-   if(!count) no_dfs = true;
-   if((!no_dfs) && is_marked() && getTypeInt() == AIG_GATE && searched_level != level) { cout << " (*)" << endl; return; }
+   cout << g->getTypeStr() << " " << g->getId();
+   size_t count = 0;
+   if(in) { for(int i = 0; i < 2; ++i) if(g->getIn(i)) ++count; }
+   else count = g->getOutSize();
+   if(count && g->is_marked() && g->getTypeInt() == AIG_GATE && searched_level != level) { cout << " (*)" << endl; return false; }
    else cout << endl;
+   if(searched_level == level) return false;
+   g->mark();
+   return true;
+}
 
-   if(searched_level == level) return;
-   mark();
-   
-   if(in) 
-   {
-      for(int i = 0; i < 2; ++i)
-      {
-         if(!getIn(i)) continue;
-         for(int j = 0; j < searched_level + 1; ++j) cout << "  ";
-         if(fanin_inv(i)) cout << "!";
-         getIn(i)->dfs(in, level, searched_level + 1);
-      }
-   }
-   else
+void
+CirGate::dfs(bool in, int level) const
+{
+   struct Frame { const CirGate* gate; int depth; size_t next; };
+   vector<Frame> stack;
+   if(reportLine(this, in, level, 0)) stack.push_back(Frame{ this, 0, 0 });
+   while(!stack.empty())
    {
-      for(size_t i = 0; i < _fanout.size(); ++i)
-      {
-         for(int j = 0; j < searched_level + 1; ++j) cout << "  ";
-         if(fanout_inv(i)) cout << "!";
-         getOut(i)->dfs(in, level, searched_level + 1);
-      }
+      Frame& f = stack.back();
+      size_t n = (in)? 2 : f.gate->_fanout.size();
+      if(f.next == n) { stack.pop_back(); continue; }
+      size_t i = f.next++;
+      const CirGate* next = (in)? f.gate->getIn(i) : f.gate->getOut(i);
+      if(!next) continue;
+      int depth = f.depth + 1;
+      for(int j = 0; j < depth; ++j) cout << "  ";
+      if((in)? f.gate->fanin_inv(i) : f.gate->fanout_inv(i)) cout << "!";
+      if(reportLine(next, in, level, depth)) stack.push_back(Frame{ next, depth, 0 });
    }
 }
 
 void
 CirGate::dfs(IdList& idList) const
 {
-   if(getTypeInt() == UNDEF_GATE) return;
-   for(int i = 0; i < 2; ++i) { if(!getIn(i)) continue; if(!getIn(i)->is_marked()) getIn(i)->dfs(idList); }
-   if(getTypeInt() == AIG_GATE) idList.push_back(getId());
-   mark();
+   postOrder([&idList](const CirGate* g) { if(g->getTypeInt() == AIG_GATE) idList.push_back(g->getId()); });
 }
 
 void
@@ -13,6 +13,7 @@
 #include <vector>
 #include <iostream>
 #include "cirDef.h"
+#include "cirMemMgr.h"
 #include "sat.h"
 
 #include <algorithm>
@@ -21,7 +22,7 @@ using namespace std;
 
 // TODO: Feel free to define your own classes, variables, or functions.
 
-bool out_comp(CirGate* & a, CirGate* & b);
+bool out_comp(CirGate* const& a, CirGate* const& b);
 
 class CirGate;
 
@@ -30,11 +31,13 @@ class CirGate;
 //------------------------------------------------------------------------
 class CirGate
 {
+   USE_CIR_MEM_MGR
+
 public:
    CirGate() {}
 	CirGate(int ti, size_t id, unsigned l) : _typeInt(ti), _fanin1(0), _fanin2(0), _id(id), _line(l), _mark(0), _symbol(0) { }
 	CirGate(int ti, size_t id) : _typeInt(ti), _fanin1(0), _fanin2(0), _id(id), _mark(0), _symbol(0) { }
-   virtual ~CirGate() { if(_symbol) delete[] _symbol; }
+   virtual ~CirGate() {}
 
    // Basic access methods
    string getTypeStr() const
@@ -54,6 +57,7 @@ public:
 	int getTypeInt() const { return _typeInt; }
 	string getSymbol() const { if(!_symbol) return ""; return string(_symbol); }
 	CirGate* getIn(int num) const { return (!num)? (CirGate*)(size_t(_fanin1) & (~1)) : (CirGate*)(size_t(_fanin2) & (~1)); }
+	unsigned getInLit(int num) const { return (getIn(num)->getId() << 1) | unsigned(fanin_inv(num)); }
 	CirGate* getOut(int num) const { return (CirGate*)(size_t(_fanout[num]) & (~1)); }
    void removeOut(size_t id) { for(size_t i = 0; i < _fanout.size(); ++i) if(getOut(i)->getId() == id) { _fanout.erase(_fanout.begin() + i); return; } }
    size_t getOutSize() const { return _fanout.size(); }
@@ -61,6 +65,7 @@ public:
    int findOut(size_t id) const { for(size_t i = 0; i < _fanout.size(); ++i) if(getOut(i)->getId() == id) return i; return -1;}
 
    // Basic setting methods
+   void setId(unsigned id) { _id = id; }
 	void setInGate(CirGate* gate1, CirGate* gate2, bool inv1, bool inv2)
 	{
 		if(inv1) _fanin1 = (CirGate*)(size_t(gate1) | 1);
@@ -73,15 +78,40 @@ public:
 		if(num) _fanin2 = (inv)? (CirGate*)(size_t(gate) | 1) : gate;
 		else _fanin1 = (inv)? (CirGate*)(size_t(gate) | 1) : gate;
 	}
-   void setOutGate(CirGate* gate, bool inv) { if(inv) _fanout.push_back((CirGate*)(size_t(gate) | 1)); else _fanout.push_back(gate); sort_out(); }
-	void setSymbol(string sym) { _symbol = new char[sym.size() + 1]; strcpy(_symbol, sym.c_str()); }
-	void sort_out() { sort(_fanout.begin(), _fanout.begin() + _fanout.size(), out_comp); }
-	void merge(CirGate* gate);
+   // keeps _fanout sorted by id; appending in id order (as readCircuit does) costs O(1).
+   // "m" is the CirMemMgr of the circuit, which holds fanout arrays and symbols
+   void setOutGate(CirGate* gate, bool inv, CirMemMgr& m)
+	{
+		CirGate* g = (inv)? (CirGate*)(size_t(gate) | 1) : gate;
+		if(!_fanout.size() || !out_comp(g, _fanout[_fanout.size() - 1])) _fanout.push_back(g, m);
+		else _fanout.insert(upper_bound(_fanout.begin(), _fanout.end(), g, out_comp), g, m);
+	}
+   void reserveOut(size_t n, CirMemMgr& m) { _fanout.reserve(n, m); }
+	void setSymbol(string sym, CirMemMgr& m) { _symbol = m.allocStr(sym.c_str()); }
+	void merge(CirGate* gate, bool inv, const string& op, CirMemMgr& m);
 
    // dfs functions
    void dfs(size_t& num) const;
-	void dfs(bool in, int level, int searched_level = 0) const;
+	void dfs(bool in, int level) const;
 	void dfs(IdList& idList) const;
+	// call visit(g) on every unmarked, defined gate in the fanin cone, fanins first
+	template <class Visit> void postOrder(Visit visit) const
+	{
+		if(getTypeInt() == UNDEF_GATE) return;
+		vector<pair<const CirGate*, int> > stack(1, make_pair(this, 0));
+		mark();
+		while(!stack.empty())
+		{
+			const CirGate* g = stack.back().first;
+			int i = stack.back().second;
+			if(i == 2) { visit(g); stack.pop_back(); continue; }
+			++stack.back().second;
+			CirGate* in = g->getIn(i);
+			if(!in || in->is_marked() || in->getTypeInt() == UNDEF_GATE) continue;
+			in->mark();
+			stack.push_back(make_pair(in, 0));
+		}
+	}
    void mark() const { _mark = _state; }
 	static void resetMark() { ++_state; }
 
@@ -102,7 +132,7 @@ public:
 private:
 protected:
 	int _typeInt;
-	GateList _fanout;
+	FanoutList _fanout;
 	CirGate* _fanin1;
 	CirGate* _fanin2;
 	unsigned _id;
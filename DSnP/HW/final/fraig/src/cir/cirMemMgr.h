@@ -0,0 +1,144 @@
+/****************************************************************************
+  FileName     [ cirMemMgr.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the circuit-scoped memory arena ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_MEM_MGR_H
+#define CIR_MEM_MGR_H
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+class CirGate;
+
+//--------------------------------------------------------------------------
+// Define MACROs
+//--------------------------------------------------------------------------
+// Each CirMgr owns one CirMemMgr and passes it to everything that
+// allocates, e.g. "new(_mem) AIGGate(id, line)". Gates, fanout arrays and
+// symbols are cut out of its blocks and are only given back when the
+// CirMgr is deleted, so "delete" on such an object just runs the destructor.
+#define USE_CIR_MEM_MGR                                                      \
+public:                                                                      \
+   void* operator new(size_t t, CirMemMgr& m) { return m.alloc(t); }        \
+   void  operator delete(void*, CirMemMgr&) {}                               \
+   void  operator delete(void*) {}                                           \
+private:
+
+#define CIR_SIZE_T     sizeof(size_t)
+#define cirToSizeT(t)  ((t % CIR_SIZE_T)? (CIR_SIZE_T * (t / CIR_SIZE_T + 1)) : t)
+
+//--------------------------------------------------------------------------
+// Class Definitions
+//--------------------------------------------------------------------------
+class CirMemMgr
+{
+public:
+   CirMemMgr(size_t b = 1 << 20) : _blockSize(b), _ptr(0), _end(0) {}
+   ~CirMemMgr() { reset(); }
+
+   // Get 't' bytes, promoted to a multiple of size_t
+   void* alloc(size_t t) {
+      t = cirToSizeT(t);
+      if(t > size_t(_end - _ptr)) newBlock(t);
+      void* ret = _ptr; _ptr += t;
+      return ret;
+   }
+   // Arrays of (1 << c) gate pointers; freed arrays are kept in _recycle[c]
+   // and the first pointer of a freed array links to the next one
+   CirGate** allocArr(unsigned c) {
+      if(c < _recycle.size() && _recycle[c]) {
+         CirGate** ret = _recycle[c];
+         _recycle[c] = *(CirGate***)ret;
+         return ret;
+      }
+      return (CirGate**)alloc(sizeof(CirGate*) << c);
+   }
+   void freeArr(CirGate** p, unsigned c) {
+      if(c >= _recycle.size()) _recycle.resize(c + 1, 0);
+      *(CirGate***)p = _recycle[c]; _recycle[c] = p;
+   }
+   char* allocStr(const char* s) {
+      size_t n = strlen(s) + 1;
+      char* ret = (char*)alloc(n); memcpy(ret, s, n);
+      return ret;
+   }
+   void reset() {
+      for(size_t i = 0; i < _blocks.size(); ++i) delete [] _blocks[i];
+      _blocks.clear(); _recycle.clear();
+      _ptr = _end = 0;
+   }
+
+private:
+   size_t               _blockSize;
+   char*                _ptr;       // free space of the last block
+   char*                _end;
+   vector<char*>        _blocks;
+   vector<CirGate**>    _recycle;
+
+   void newBlock(size_t t) {
+      size_t b = (t > _blockSize)? t : _blockSize;
+      _blocks.push_back(new char[b]);
+      _ptr = _blocks.back(); _end = _ptr + b;
+   }
+};
+
+//--------------------------------------------------------------------------
+//   FanoutList
+//--------------------------------------------------------------------------
+// The vector-like fanout array of a gate, stored in the CirMemMgr of its
+// circuit, which every call that may allocate or free the array is given.
+// The capacity is a power of two; when it grows, the old array is recycled.
+class FanoutList
+{
+public:
+   FanoutList() : _arr(0), _size(0), _cls(0) {}
+
+   size_t size() const { return _size; }
+   bool empty() const { return !_size; }
+   CirGate*& operator [] (size_t i) { return _arr[i]; }
+   CirGate* const& operator [] (size_t i) const { return _arr[i]; }
+   CirGate** begin() { return _arr; }
+   CirGate** end() { return _arr + _size; }
+
+   void push_back(CirGate* g, CirMemMgr& m) { if(_size == capacity()) grow(_cls + 1, m); _arr[_size++] = g; }
+   void insert(CirGate** p, CirGate* g, CirMemMgr& m) {
+      size_t k = p - _arr;
+      if(_size == capacity()) grow(_cls + 1, m);
+      memmove(_arr + k + 1, _arr + k, (_size - k) * sizeof(CirGate*));
+      _arr[k] = g; ++_size;
+   }
+   void erase(CirGate** p) { memmove(p, p + 1, (end() - p - 1) * sizeof(CirGate*)); --_size; }
+   void reserve(size_t n, CirMemMgr& m) {
+      unsigned c = 0;
+      while((size_t(1) << c) < n) ++c;
+      if(n > capacity()) grow(c, m);
+   }
+   // also gives the array back; a cleared list is usually a dead gate's
+   void clear(CirMemMgr& m) {
+      if(_arr) m.freeArr(_arr, _cls);
+      _arr = 0; _size = 0; _cls = 0;
+   }
+
+private:
+   CirGate**   _arr;
+   unsigned    _size;
+   unsigned    _cls;    // capacity is (1 << _cls) once _arr is allocated
+
+   size_t capacity() const { return _arr? (size_t(1) << _cls) : 0; }
+   // to class c, but never below 2 entries
+   void grow(unsigned c, CirMemMgr& m) {
+      if(c < 1) c = 1;
+      CirGate** a = m.allocArr(c);
+      if(_arr) { memcpy(a, _arr, _size * sizeof(CirGate*)); m.freeArr(_arr, _cls); }
+      _arr = a; _cls = c;
+   }
+};
+
+#endif // CIR_MEM_MGR_H
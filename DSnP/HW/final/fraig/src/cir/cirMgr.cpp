@@ -13,6 +13,11 @@
 #include <ctype.h>
 #include <cassert>
 #include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "cirMgr.h"
 #include "cirGate.h"
 #include "util.h"
@@ -58,6 +63,113 @@ static unsigned colNo  = 0;  // in printing, colNo needs to ++
 static string errMsg;
 static int errInt;
 static CirGate *errGate;
+static const size_t parseChunkLines = 1 << 16;  // min. AIG lines per parsing thread
+
+// A line of the memory-mapped design file, without the '\n'.
+// It refers to the mapped buffer (no copy) and provides the few string
+// operations the parser uses, with the same semantics as std::string,
+// myStrGetTok() and myStr2Int().
+class CirLine
+{
+public:
+   CirLine(const char* s = 0, size_t n = 0) : _s(s), _n(n) {}
+
+   size_t size() const { return _n; }
+   char operator [] (size_t i) const { return _s[i]; }
+   string str() const { return string(_s, _n); }
+   CirLine substr(size_t pos) const { return CirLine(_s + pos, _n - pos); }
+
+   size_t find_first_not_of(char c, size_t pos = 0) const {
+      for(; pos < _n; ++pos) if(_s[pos] != c) return pos;
+      return string::npos;
+   }
+   size_t find_first_of(char c, size_t pos = 0) const {
+      for(; pos < _n; ++pos) if(_s[pos] == c) return pos;
+      return string::npos;
+   }
+   size_t getTok(CirLine& tok, size_t pos = 0, char del = ' ') const {
+      size_t begin = find_first_not_of(del, pos);
+      if(begin == string::npos) { tok = CirLine(); return begin; }
+      size_t end = find_first_of(del, begin);
+      tok = CirLine(_s + begin, ((end == string::npos)? _n : end) - begin);
+      return end;
+   }
+   bool toInt(int& num) const {
+      num = 0;
+      size_t i = 0;
+      int sign = 1;
+      if(_n && _s[0] == '-') { sign = -1; i = 1; }
+      bool valid = false;
+      for(; i < _n; ++i) {
+         if(!isdigit(_s[i])) return false;
+         num = num * 10 + int(_s[i] - '0');
+         valid = true;
+      }
+      num *= sign;
+      return valid;
+   }
+
+private:
+   const char* _s;
+   size_t      _n;
+};
+
+// The design file mapped into memory and read line by line in place.
+// As before, only lines terminated by '\n' are seen, unless "last" is set
+// (used for the header of a file without any '\n').
+class AagFile
+{
+public:
+   AagFile() : _buf(0), _cur(0), _end(0), _size(0) {}
+   ~AagFile() { if(_size) munmap((void*)_buf, _size); }
+
+   bool open(const string& fileName) {
+      int fd = ::open(fileName.c_str(), O_RDONLY);
+      if(fd < 0) return false;
+      struct stat st;
+      if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) { ::close(fd); return false; }
+      if(st.st_size > 0) {
+         void* p = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+         if(p == MAP_FAILED) { ::close(fd); return false; }
+         madvise(p, st.st_size, MADV_SEQUENTIAL);
+         _buf = (const char*)p; _size = st.st_size;
+      }
+      ::close(fd);
+      _cur = _buf; _end = _buf + _size;
+      return true;
+   }
+   // binary AIGER number: 7 bits per byte, LSB first, bit 7 set if more follow
+   bool getUInt(unsigned& x) {
+      x = 0;
+      for(unsigned shift = 0; _cur != _end && shift < 32; shift += 7) {
+         unsigned char c = *_cur++;
+         x |= unsigned(c & 0x7f) << shift;
+         if(!(c & 0x80)) return true;
+      }
+      return false;
+   }
+   bool getLine(CirLine& line, bool last = false) {
+      const char* nl = (_cur == _end)? 0 : (const char*)memchr(_cur, '\n', _end - _cur);
+      if(!nl && last) nl = _end;
+      if(!nl) return false;
+      line = CirLine(_cur, nl - _cur);
+      _cur = (nl == _end)? _end : nl + 1;
+      return true;
+   }
+
+private:
+   const char* _buf;
+   const char* _cur;
+   const char* _end;
+   size_t      _size;
+};
+
+static void
+writeUInt(ostream& os, size_t x)
+{
+   for(; x & ~size_t(0x7f); x >>= 7) os.put(char((x & 0x7f) | 0x80));
+   os.put(char(x));
+}
 
 static bool
 parseError(CirParseError err)
@@ -146,45 +258,125 @@ parseError(CirParseError err)
    return false;
 }
 
+// Parse the AIG line "lhs rhs0 rhs1" into lit[0~2].
+// With "mgr" the errors are reported by parseError(), as the line's turn
+// in the file has come, and a redefined lhs is checked against its gates.
+// Without it (in the parsing threads) it only tells if the line is fine
+// otherwise, and no shared error variables are touched.
+static bool
+parseAigLine(const CirLine& line, int maxVar, int* lit, const CirMgr* mgr)
+{
+   unsigned col = 0;
+   int val = 0, current;
+   unsigned& c = (mgr)? colNo : col;
+   int& e = (mgr)? errInt : val;
+   auto error = [mgr](CirParseError err) { return (mgr)? parseError(err) : false; };
+   size_t AIGpos = line.find_first_not_of(' ');
+   // cerr << "AIGpos : " << AIGpos << endl;
+   if(AIGpos != 0) return error(EXTRA_SPACE);
+   AIGpos = line.find_first_not_of(char(9));
+   // cerr << "AIGpos : " << AIGpos << endl;
+   if(AIGpos != 0) { e = 9; return error(ILLEGAL_WSPACE); }
+   // parse error
+   CirLine str;
+   AIGpos = line.getTok(str, AIGpos);
+   if(AIGpos == string::npos) { ++c; return error(MISSING_SPACE); }
+   str.toInt(current);
+   if(current == 0 || current == 1) { e = current; return error(REDEF_CONST); }
+   if(current / 2 > maxVar) { e = current; return error(MAX_LIT_ID); }
+   c = AIGpos;
+   if(mgr && mgr->getGate(current / 2))
+   {
+      if(mgr->getGate(current / 2)->getTypeInt() != UNDEF_GATE)
+      {
+         e = current;
+         errGate = mgr->getGate(current / 2);
+         return error(REDEF_GATE);
+      } 
+   }
+   lit[0] = current;
+   size_t newPos = line.find_first_not_of(' ', AIGpos);
+   c++;
+   if(AIGpos + 1 == newPos) AIGpos = newPos;
+   else { return error(EXTRA_SPACE); }
+   AIGpos = line.getTok(str, AIGpos);
+   if(AIGpos == string::npos) { ++c; return error(MISSING_SPACE); }
+   str.toInt(current);
+   if(current / 2 > maxVar) { e = current; return error(MAX_LIT_ID); }
+   c = AIGpos;
+   lit[1] = current;
+   // third num
+   newPos = line.find_first_not_of(' ', AIGpos);
+   c++;
+   if(AIGpos + 1 == newPos) AIGpos = newPos;
+   else { return error(EXTRA_SPACE); }
+   AIGpos = line.getTok(str, AIGpos);
+   c += str.size();
+   if(AIGpos != string::npos) return error(MISSING_NEWLINE);
+   str.toInt(current);
+   if(current / 2 > maxVar) { e = current; return error(MAX_LIT_ID); }
+   c = AIGpos;
+   lit[2] = current;
+   return true;
+}
+
+// Parse all AIG lines, in chunks of at least parseChunkLines lines per
+// thread. Return the index of the first line with an error, or the number
+// of lines if there is none.
+static size_t
+parseAigLines(const vector<CirLine>& lines, int maxVar, vector<int>& lits)
+{
+   size_t n = lines.size();
+   size_t nThreads = std::min<size_t>(std::max(thread::hardware_concurrency(), 1U), n / parseChunkLines + 1);
+   vector<size_t> bad(nThreads, n);
+   auto parse = [&](size_t t) {
+      for(size_t k = n * t / nThreads, end = n * (t + 1) / nThreads; k < end; ++k)
+         if(!parseAigLine(lines[k], maxVar, &lits[3 * k], 0)) { bad[t] = k; return; }
+   };
+   vector<thread> workers;
+   for(size_t t = 1; t < nThreads; ++t) workers.push_back(thread(parse, t));
+   parse(0);
+   for(size_t t = 0; t < workers.size(); ++t) workers[t].join();
+   return *min_element(bad.begin(), bad.end());
+}
+
 /**************************************************************/
 /*   class CirMgr member functions for circuit construction   */
 /**************************************************************/
-CirMgr::CirMgr() { sorted_list.push_back(new CONSTGate(0, 0)); for(int i = 0; i < 5; ++i) header[i] = 0; }
-CirMgr::~CirMgr() { delete sorted_list[0]; for(size_t i = 0; i < gate_list.size(); ++i) delete gate_list[i]; lineNo = 0; colNo = 0; }
+CirMgr::CirMgr() : _simLog(0), _simThreads(1), _fraigBudget(10000), _fraigThreads(1), _dfsDead(0), _fecInit(false)
+{
+   sorted_list.push_back(new(_mem) CONSTGate(0, 0)); for(int i = 0; i < 5; ++i) header[i] = 0;
+}
+// Gates hold nothing outside _mem, so they are freed with it in one go
+CirMgr::~CirMgr() { lineNo = 0; colNo = 0; }
 bool
-CirMgr::readCircuit(const string& fileName)
+CirMgr::readCircuit(const string& fileName, bool strash)
 {
-   fstream file;
-   file.open(fileName, fstream::in);
-   if(!file.is_open()) { cerr << "Cannot open design \"" << fileName << "\"!!" << endl; return false;}
-   char c;
-   vector<string> wholeFile;
-   wholeFile.push_back("");
-   while(file.get(c))
-      if(c == '\n') wholeFile.push_back("");
-      else wholeFile.back().push_back(c);
-   wholeFile.pop_back();
-
-   string head;
-   if(!wholeFile[0].size()) { errMsg = "aag"; return parseError(MISSING_IDENTIFIER); }
+   AagFile file;
+   if(!file.open(fileName)) { cerr << "Cannot open design \"" << fileName << "\"!!" << endl; return false;}
+   CirLine line, head;
+   if(!file.getLine(line, true) || !line.size()) { errMsg = "aag"; return parseError(MISSING_IDENTIFIER); }
    // before "aag"
-   size_t pos = wholeFile[0].find_first_not_of(' ');
+   size_t pos = line.find_first_not_of(' ');
    // cerr << "pos : " << pos << endl;
    if(pos != 0) return parseError(EXTRA_SPACE);
-   pos = wholeFile[0].find_first_not_of(char(9));
+   pos = line.find_first_not_of(char(9));
    // cerr << "pos : " << pos << endl;
    if(pos != 0) { errInt = 9; return parseError(ILLEGAL_WSPACE); }
    // "aag"
-   pos = myStrGetTok(wholeFile[0], head);
+   pos = line.getTok(head);
    // cerr << "get head (" << head << ") from 0 to " << pos << endl;
    // cerr << "myStrNCmp : " << myStrNCmp(head, "aag", 3) << endl;
-   if(myStrNCmp(head, "aag", 3) != 0) { errMsg = head; return parseError(ILLEGAL_IDENTIFIER); }
-   else if(myStrNCmp(head, "aag", 3) == 0 && head.size() > 3)
+   // "aig" is binary AIGER: implicit PIs and delta-encoded AIGs
+   bool binary = (head.size() >= 3 && myStrNCmp(head.str(), "aig", 3) == 0);
+   const char* ident = (binary)? "aig" : "aag";
+   if(myStrNCmp(head.str(), ident, 3) != 0) { errMsg = head.str(); return parseError(ILLEGAL_IDENTIFIER); }
+   else if(myStrNCmp(head.str(), ident, 3) == 0 && head.size() > 3)
    {
-      string str = head.substr(3);
+      CirLine str = head.substr(3);
       int num;
-      if(myStr2Int(str, num)) { colNo = 3; return parseError(MISSING_SPACE); }
-      else { errMsg = head; return parseError(ILLEGAL_IDENTIFIER); }
+      if(str.toInt(num)) { colNo = 3; return parseError(MISSING_SPACE); }
+      else { errMsg = head.str(); return parseError(ILLEGAL_IDENTIFIER); }
    }
    colNo = pos;
    // MILOA
@@ -192,7 +384,7 @@ CirMgr::readCircuit(const string& fileName)
    for(int i = 0; i < 5; ++i)
    {
       // cerr << pos << endl;
-      size_t newPos = wholeFile[0].find_first_not_of(' ', pos);
+      size_t newPos = line.find_first_not_of(' ', pos);
       // cerr << "[" << i << "]pos : " << pos << ", newPos : " << newPos << endl;
       if(pos == string::npos) { errMsg = "number of variables"; return parseError(MISSING_NUM);  }
       if(pos + 1 == newPos) pos = newPos;
@@ -200,15 +392,15 @@ CirMgr::readCircuit(const string& fileName)
       else if(pos == newPos) return parseError(MISSING_SPACE);
       else { ++colNo; return parseError(EXTRA_SPACE); }
       colNo++;
-      newPos = wholeFile[0].find_first_not_of(char(9), pos);
+      newPos = line.find_first_not_of(char(9), pos);
       // cerr << "test char(9) newPos : " << newPos << endl;
       if(pos != newPos) { errInt = 9; return parseError(ILLEGAL_WSPACE); }
-      string str, str2;
+      CirLine str, str2;
       size_t pos1;
-      pos1 = myStrGetTok(wholeFile[0], str, pos);
-      myStrGetTok(wholeFile[0], str2, pos, char(9));
-      if(myStr2Int(str, header[i])) pos = pos1;
-      else if(myStr2Int(str2, header[i])) { ++colNo; return parseError(MISSING_SPACE); }
+      pos1 = line.getTok(str, pos);
+      line.getTok(str2, pos, char(9));
+      if(str.toInt(header[i])) pos = pos1;
+      else if(str2.toInt(header[i])) { ++colNo; return parseError(MISSING_SPACE); }
       else
       {
          switch(i)
@@ -219,7 +411,7 @@ CirMgr::readCircuit(const string& fileName)
             case 3: errMsg = "number of POs"; break;
             case 4: errMsg = "number of AIGs"; break;
          }
-         errMsg += "(" + str + ")";
+         errMsg += "(" + str.str() + ")";
          return parseError(ILLEGAL_NUM);
       }
       //if(!myStr2Int(str, header[i])) { ++colNo; return parseError(MISSING_SPACE); }
@@ -228,6 +420,7 @@ CirMgr::readCircuit(const string& fileName)
    if(pos != string::npos) return parseError(MISSING_NEWLINE);
    if(header[0] < header[1] + header[2] + header[4]) { errMsg = "Number of variables"; errInt = header[0]; return parseError(NUM_TOO_SMALL); }
    if(header[2] != 0) { errMsg = "latches"; return parseError(ILLEGAL_NUM); }
+   if(binary && header[0] > header[1] + header[2] + header[4]) { errMsg = "Number of variables"; errInt = header[0]; return parseError(NUM_TOO_BIG); }
    colNo = 0;
    ++lineNo;
    // cout << "line " << lineNo << " done" << endl;
@@ -235,22 +428,29 @@ CirMgr::readCircuit(const string& fileName)
    int current;
    // cerr << "PI" << endl;
    // PI
-   for(int i = 0; i < header[1]; ++i)
+   for(int i = 0; binary && i < header[1]; ++i)
+   {
+      ++lineNo;
+      gate_list.push_back(new(_mem) PIGate(i + 1, lineNo));
+      sorted_list[i + 1] = gate_list.back();
+      _piList.push_back(gate_list.back());
+   }
+   for(int i = 0; !binary && i < header[1]; ++i)
    {
       colNo = 0;
       // before PI
-      if(wholeFile.size() == lineNo) { errMsg = "PI"; return parseError(MISSING_DEF); }
-      size_t PIpos = wholeFile[i + 1].find_first_not_of(' ');
+      if(!file.getLine(line)) { errMsg = "PI"; return parseError(MISSING_DEF); }
+      size_t PIpos = line.find_first_not_of(' ');
       // cerr << "PIpos : " << PIpos << endl;
       if(PIpos == string::npos) { errMsg = "PI literal ID"; return parseError(MISSING_NUM); }
       if(PIpos != 0) return parseError(EXTRA_SPACE);
-      PIpos = wholeFile[i + 1].find_first_not_of(char(9));
+      PIpos = line.find_first_not_of(char(9));
       // cerr << "PIpos : " << PIpos << endl;
       if(PIpos != 0) { errInt = 9; return parseError(ILLEGAL_WSPACE); }
       // parse error
-      string str;
-      PIpos = myStrGetTok(wholeFile[i + 1], str, PIpos);
-      if(!myStr2Int(str, current)) { colNo += str.size(); return parseError(MISSING_SPACE); }
+      CirLine str;
+      PIpos = line.getTok(str, PIpos);
+      if(!str.toInt(current)) { colNo += str.size(); return parseError(MISSING_SPACE); }
       if(PIpos != string::npos) { colNo += str.size(); return parseError(MISSING_NEWLINE); }
       // cerr << "current : " << current << endl;
       // cerr << "line no : " << lineNo << endl;
@@ -277,109 +477,87 @@ CirMgr::readCircuit(const string& fileName)
       //    }
       ++lineNo;
       // init gate
-      vector<size_t> v;
-      v.push_back(current);
-      value.push_back(v);
-      gate_list.push_back(new PIGate(v[0] / 2, lineNo));
+      gate_list.push_back(new(_mem) PIGate(current / 2, lineNo));
       sorted_list[gate_list.back()->getId()] = gate_list.back();
+      _piList.push_back(gate_list.back());
    }
    // LATCH
    for(int i = header[1]; i < header[1] + header[2]; ++i, ++lineNo) {}
    // PO
    // cerr << "PO" << endl;
+   // fanin literals of POs and AIGs in file order, for linking
+   vector<int> poLits, aigLits;
    for(int i = header[1] + header[2]; i < header[1] + header[2] + header[3]; ++i)
    {
       colNo = 0;
       // before PO
-      if(wholeFile.size() == lineNo) { errMsg = "PO"; return parseError(MISSING_DEF); }
-      size_t POpos = wholeFile[i + 1].find_first_not_of(' ');
+      if(!file.getLine(line)) { errMsg = "PO"; return parseError(MISSING_DEF); }
+      size_t POpos = line.find_first_not_of(' ');
       // cerr << "POpos : " << POpos << endl;
       if(POpos == string::npos) { errMsg = "PO literal ID"; return parseError(MISSING_NUM); }
       if(POpos != 0) return parseError(EXTRA_SPACE);
-      POpos = wholeFile[i + 1].find_first_not_of(char(9));
+      POpos = line.find_first_not_of(char(9));
       // cerr << "POpos : " << POpos << endl;
       if(POpos != 0) { errInt = 9; return parseError(ILLEGAL_WSPACE); }
       // parse error
-      string str;
-      POpos = myStrGetTok(wholeFile[i + 1], str, POpos);
-      if(!myStr2Int(str, current)) { ++colNo; return parseError(MISSING_SPACE); }
+      CirLine str;
+      POpos = line.getTok(str, POpos);
+      if(!str.toInt(current)) { ++colNo; return parseError(MISSING_SPACE); }
       if(POpos != string::npos) return parseError(MISSING_NEWLINE);
       // cerr << "current : " << current << endl;
       // cerr << "line no : " << lineNo << endl;
       if(current / 2 > header[0]) { errInt = current; return parseError(MAX_LIT_ID); }
       ++lineNo;
       // init gate
-      vector<size_t> v;
-      v.push_back(header[0] + i - header[1] + header[2] + 1);
-      v.push_back(current);
-      value.push_back(v);
-      gate_list.push_back(new POGate(header[0] + i - header[1] + header[2] + 1, lineNo));
+      poLits.push_back(current);
+      gate_list.push_back(new(_mem) POGate(header[0] + i - header[1] + header[2] + 1, lineNo));
       sorted_list[gate_list.back()->getId()] = gate_list.back();
+      _poList.push_back(gate_list.back());
    }
    //AIG
    // cerr << "AIG" << endl;
-   for(int i = header[1] + header[2] + header[3]; i < header[1] + header[2] + header[3] + header[4]; ++i)
+   for(int i = 0; binary && i < header[4]; ++i)
    {
-      colNo = 0;
-      // before PO
-      vector<size_t> currents;
-      if(wholeFile.size() == lineNo) { errMsg = "AIG"; return parseError(MISSING_DEF); }
-      size_t AIGpos = wholeFile[i + 1].find_first_not_of(' ');
-      // cerr << "AIGpos : " << AIGpos << endl;
-      if(AIGpos != 0) return parseError(EXTRA_SPACE);
-      AIGpos = wholeFile[i + 1].find_first_not_of(char(9));
-      // cerr << "AIGpos : " << AIGpos << endl;
-      if(AIGpos != 0) { errInt = 9; return parseError(ILLEGAL_WSPACE); }
-      // parse error
-      string str;
-      AIGpos = myStrGetTok(wholeFile[i + 1], str, AIGpos);
-      if(AIGpos == string::npos) { ++colNo; return parseError(MISSING_SPACE); }
-      myStr2Int(str, current);
-      if(current == 0 || current == 1) { errInt = current; return parseError(REDEF_CONST); }
-      if(current / 2 > header[0]) { errInt = current; return parseError(MAX_LIT_ID); }
-      colNo = AIGpos;
-      if(getGate(current / 2))
+      // lhs = 2(I + L + i + 1), rhs0 = lhs - delta0, rhs1 = rhs0 - delta1
+      unsigned delta0, delta1;
+      if(!file.getUInt(delta0) || !file.getUInt(delta1)) { errMsg = "AIG"; return parseError(MISSING_DEF); }
+      size_t lhs = 2 * (header[1] + header[2] + i + 1);
+      if(delta0 == 0 || delta0 > lhs) { errMsg = "AIG delta(" + to_string(delta0) + ")"; return parseError(ILLEGAL_NUM); }
+      if(delta1 > lhs - delta0) { errMsg = "AIG delta(" + to_string(delta1) + ")"; return parseError(ILLEGAL_NUM); }
+      ++lineNo;
+      aigLits.push_back(lhs); aigLits.push_back(lhs - delta0); aigLits.push_back(lhs - delta0 - delta1);
+      gate_list.push_back(new(_mem) AIGGate(lhs / 2, lineNo));
+      sorted_list[lhs / 2] = gate_list.back();
+   }
+   // The AIG lines are parsed in parallel chunks into a flat literal array.
+   // The gates are then created in file order, where redefinitions, which
+   // depend on the lines before, are checked; the first faulty line is
+   // parsed again to report it exactly as a sequential read would.
+   if(!binary)
+   {
+      vector<CirLine> aigLines;
+      aigLines.reserve(header[4]);
+      while((int)aigLines.size() < header[4] && file.getLine(line)) aigLines.push_back(line);
+      vector<int>& lits = aigLits;
+      lits.resize(3 * aigLines.size());
+      size_t bad = parseAigLines(aigLines, header[0], lits);
+      for(size_t k = 0; k < aigLines.size(); ++k)
       {
-         if(getGate(current / 2)->getTypeInt() != UNDEF_GATE)
+         colNo = 0;
+         if(k == bad) return parseAigLine(aigLines[k], header[0], &lits[3 * k], this);
+         int lhs = lits[3 * k];
+         if(getGate(lhs / 2) && getGate(lhs / 2)->getTypeInt() != UNDEF_GATE)
          {
-            errInt = current;
-            errGate = getGate(current / 2);
+            errInt = lhs;
+            errGate = getGate(lhs / 2);
             return parseError(REDEF_GATE);
-         } 
+         }
+         ++lineNo;
+         gate_list.push_back(new(_mem) AIGGate(lhs / 2, lineNo));
+         sorted_list[gate_list.back()->getId()] = gate_list.back();
       }
-      currents.push_back(current);
-      size_t newPos = wholeFile[i + 1].find_first_not_of(' ', AIGpos);
-      // cerr << "[" << i << "]AIGpos : " << AIGpos << ", newPos : " << newPos << endl;
-      colNo++;
-      if(AIGpos + 1 == newPos) AIGpos = newPos;
-      else { return parseError(EXTRA_SPACE); }
-      newPos = wholeFile[0].find_first_not_of(char(9), pos);
-      // cerr << "test char(9) newPos : " << newPos << endl;
-      if(pos != newPos) { errInt = 9; return parseError(ILLEGAL_WSPACE); }
-      AIGpos = myStrGetTok(wholeFile[i + 1], str, AIGpos);
-      if(AIGpos == string::npos) { ++colNo; return parseError(MISSING_SPACE); }
-      myStr2Int(str, current);
-      if(current / 2 > header[0]) { errInt = current; return parseError(MAX_LIT_ID); }
-      colNo = AIGpos;
-      currents.push_back(current); 
-      // third num
-      newPos = wholeFile[i + 1].find_first_not_of(' ', AIGpos);
-      // cerr << "[" << i << "]AIGpos : " << AIGpos << ", newPos : " << newPos << endl;
-      colNo++;
-      if(AIGpos + 1 == newPos) AIGpos = newPos;
-      else { return parseError(EXTRA_SPACE); }
-      AIGpos = myStrGetTok(wholeFile[i + 1], str, AIGpos);
-      colNo += str.size();
-      if(AIGpos != string::npos) return parseError(MISSING_NEWLINE);
-      myStr2Int(str, current);
-      if(current / 2 > header[0]) { errInt = current; return parseError(MAX_LIT_ID); }
-      colNo = AIGpos;
-      currents.push_back(current);      
-      ++lineNo;
-
-      value.push_back(currents);
-      gate_list.push_back(new AIGGate(currents[0] / 2, lineNo));
-      sorted_list[gate_list.back()->getId()] = gate_list.back();
+      colNo = 0;
+      if((int)aigLines.size() < header[4]) { errMsg = "AIG"; return parseError(MISSING_DEF); }
    }
 
    // sorted_list.resize(header[0] + header[3] + 1, 0);// plus const gate
@@ -388,87 +566,142 @@ CirMgr::readCircuit(const string& fileName)
    
    // get symbols
    vector<pair<char, int>> defined_sym;
-   for(int i = header[1] + header[2] + header[3] + header[4] + 1; i < (int)wholeFile.size(); ++i)
+   while(file.getLine(line))
    {
       colNo = 0;
-      if(!wholeFile[i].size()) { errMsg = char(NULL); return parseError(ILLEGAL_SYMBOL_TYPE); }
-      if(wholeFile[i][0] == 'c') 
+      if(!line.size()) { errMsg = char(NULL); return parseError(ILLEGAL_SYMBOL_TYPE); }
+      if(line[0] == 'c') 
       {
          ++colNo;
-         if(wholeFile[i].size() > 1) return parseError(MISSING_NEWLINE);
+         if(line.size() > 1) return parseError(MISSING_NEWLINE);
          break;
       }
       // befor Symbol
-      size_t Spos = wholeFile[i].find_first_not_of(' ');
+      size_t Spos = line.find_first_not_of(' ');
       // cerr << "Spos : " << Spos << endl;
       if(Spos != 0) return parseError(EXTRA_SPACE);
-      Spos = wholeFile[i].find_first_not_of(char(9));
+      Spos = line.find_first_not_of(char(9));
       // cerr << "Spos : " << Spos << endl;
       if(Spos != 0) { errInt = 9; return parseError(ILLEGAL_WSPACE); }
       // i/o
-      if(wholeFile[i][0] != 'i' && wholeFile[i][0] != 'o') { errMsg = wholeFile[i][0]; return parseError(ILLEGAL_SYMBOL_TYPE); }
+      if(line[0] != 'i' && line[0] != 'o') { errMsg = line[0]; return parseError(ILLEGAL_SYMBOL_TYPE); }
       ++Spos;
       ++colNo;
       // between i/o and num
-      size_t newPos = wholeFile[i].find_first_not_of(' ', Spos);
+      size_t newPos = line.find_first_not_of(' ', Spos);
       if(newPos != Spos) return parseError(EXTRA_SPACE);
-      newPos = wholeFile[i].find_first_not_of(char(9), Spos);
+      newPos = line.find_first_not_of(char(9), Spos);
       if(newPos != Spos) { errInt = 9; return parseError(ILLEGAL_WSPACE); }
       // get gate id
-      string str, str2;
+      CirLine str, str2;
       int gate_num = 0;
       size_t pos1;
-      pos1 = myStrGetTok(wholeFile[i], str, Spos);
-      myStrGetTok(wholeFile[i], str2, Spos, char(9));
-      if(myStr2Int(str, gate_num)) Spos = pos1;
-      else if(myStr2Int(str2, gate_num)) { ++colNo; return parseError(MISSING_SPACE); }
-      else { errMsg = "symbol index(" + str + ")"; return parseError(ILLEGAL_NUM); }
-      if(wholeFile[i][0] == 'i') {if(gate_num > header[1]) { errMsg = "PI index"; errInt = gate_num; return parseError(NUM_TOO_BIG); }}
-      else if(wholeFile[i][0] == 'o') if(gate_num > header[3]) { errMsg = "PO index"; errInt = gate_num; return parseError(NUM_TOO_BIG); }
+      pos1 = line.getTok(str, Spos);
+      line.getTok(str2, Spos, char(9));
+      if(str.toInt(gate_num)) Spos = pos1;
+      else if(str2.toInt(gate_num)) { ++colNo; return parseError(MISSING_SPACE); }
+      else { errMsg = "symbol index(" + str.str() + ")"; return parseError(ILLEGAL_NUM); }
+      if(gate_num < 0) { errMsg = "symbol index(" + str.str() + ")"; return parseError(ILLEGAL_NUM); }
+      if(line[0] == 'i') {if(gate_num >= header[1]) { errMsg = "PI index"; errInt = gate_num; return parseError(NUM_TOO_BIG); }}
+      else if(line[0] == 'o') if(gate_num >= header[3]) { errMsg = "PO index"; errInt = gate_num; return parseError(NUM_TOO_BIG); }
       colNo += str.size();
       // symbol str
       if(Spos == string::npos) { errMsg = "symbolic name"; return parseError(MISSING_IDENTIFIER); }
       ++Spos;
-      if(Spos == wholeFile[i].size()) { errMsg = "symbolic name"; return parseError(MISSING_IDENTIFIER); }
-      newPos = wholeFile[i].find_first_not_of(' ', Spos);
-      str = wholeFile[i].substr(Spos);
+      if(Spos == line.size()) { errMsg = "symbolic name"; return parseError(MISSING_IDENTIFIER); }
+      newPos = line.find_first_not_of(' ', Spos);
+      str = line.substr(Spos);
       for(size_t j = 0; j < str.size(); ++j) if(!isprint(str[j])) { colNo += j + 1; errInt = int(str[j]); return parseError(ILLEGAL_SYMBOL_NAME); }
       colNo += str.size();
-      // cerr << "gate_type: " << wholeFile[i][0] << endl;
+      // cerr << "gate_type: " << line[0] << endl;
       // cerr << "gate_num : " << gate_num << endl;
       // cerr << "sym      : " << str << endl;
 
-      if(wholeFile[i][0] == 'i')
+      if(line[0] == 'i')
       {
-         if(getGate(value[gate_num][0] / 2)->getSymbol().size())
-         { errMsg = wholeFile[i][0]; errInt = gate_num; return parseError(REDEF_SYMBOLIC_NAME); }
+         if(_piList[gate_num]->getSymbol().size())
+         { errMsg = line[0]; errInt = gate_num; return parseError(REDEF_SYMBOLIC_NAME); }
       }
-      else if(wholeFile[i][0] == 'o')
+      else if(line[0] == 'o')
       {
-         if(getGate(value[gate_num + header[1] + header[2]][0])->getSymbol().size())
-         { errMsg = wholeFile[i][0]; errInt = gate_num; return parseError(REDEF_SYMBOLIC_NAME); }
+         if(_poList[gate_num]->getSymbol().size())
+         { errMsg = line[0]; errInt = gate_num; return parseError(REDEF_SYMBOLIC_NAME); }
       }
       // for(size_t j = 0; j < defined_sym.size(); ++j)
       // {
       //    // cerr << "defined_sym[" << j << "].first  : " << defined_sym[j].first << endl;
       //    // cerr << "defined_sym[" << j << "].second : " << defined_sym[j].second << endl;
-      //    if(defined_sym[j].first == wholeFile[i][0] && defined_sym[j].second == gate_num) 
-      //    { errMsg = wholeFile[i][0]; errInt = gate_num; return parseError(REDEF_SYMBOLIC_NAME); }
+      //    if(defined_sym[j].first == line[0] && defined_sym[j].second == gate_num) 
+      //    { errMsg = line[0]; errInt = gate_num; return parseError(REDEF_SYMBOLIC_NAME); }
       // }
-      // defined_sym.push_back(make_pair(wholeFile[i][0], gate_num));
+      // defined_sym.push_back(make_pair(line[0], gate_num));
       ++lineNo;
 
-      if(wholeFile[i][0] == 'i') linkSymbol(true, gate_num, str);
-      else if(wholeFile[i][0] == 'o') linkSymbol(false, gate_num, str);
+      if(line[0] == 'i') linkSymbol(true, gate_num, str.str());
+      else if(line[0] == 'o') linkSymbol(false, gate_num, str.str());
+   }
+   // a gate's row in poLits/aigLits follows from its line number
+   int poLine = header[1] + header[2] + 2, aigLine = poLine + header[3];
+   // -Strash: visit the AIGs fanins first, rewrite their fanin literals
+   // through "repl" and drop the ones hashAnd() finds another node for
+   if(strash)
+   {
+      _strash.init(header[4]);
+      vector<unsigned> repl(header[0] + 1);
+      for(size_t i = 0; i < repl.size(); ++i) repl[i] = i << 1;
+      vector<char> state(header[0] + 1, 0);   // 0: new, 1: on the stack, 2: done
+      IdList stack;
+      for(size_t k = 0; k < aigLits.size(); k += 3)
+      {
+         stack.push_back(aigLits[k] / 2);
+         while(!stack.empty())
+         {
+            unsigned id = stack.back();
+            if(state[id] == 2) { stack.pop_back(); continue; }
+            int* lit = &aigLits[3 * (sorted_list[id]->getLineNo() - aigLine)];
+            if(state[id] == 0)
+            {
+               state[id] = 1;
+               for(int j = 1; j < 3; ++j)
+               {
+                  unsigned f = lit[j] / 2;
+                  if(state[f] == 0 && sorted_list[f] && sorted_list[f]->isAig()) stack.push_back(f);
+               }
+               continue;
+            }
+            state[id] = 2; stack.pop_back();
+            unsigned lit0 = repl[lit[1] / 2] ^ (lit[1] & 1), lit1 = repl[lit[2] / 2] ^ (lit[2] & 1);
+            unsigned r = hashAnd(lit0, lit1, id);
+            if(r != (id << 1)) { repl[id] = r; sorted_list[id] = 0; }
+            else { lit[1] = lit0; lit[2] = lit1; }
+         }
+      }
+      for(size_t i = 0; i < poLits.size(); ++i) poLits[i] = repl[poLits[i] / 2] ^ (poLits[i] & 1);
    }
-   // link gates
+   // count the fanouts first, so that every fanout list is allocated once
+   // and floating fanins get their UNDEF gates
+   vector<unsigned> nOut(header[0] + 1, 0);
+   for(size_t i = 0; i < poLits.size(); ++i) ++nOut[poLits[i] / 2];
+   for(size_t i = 0; i < aigLits.size(); i += 3)
+      if(sorted_list[aigLits[i] / 2]) { ++nOut[aigLits[i + 1] / 2]; ++nOut[aigLits[i + 2] / 2]; }
+   for(int i = 0; i <= header[0]; ++i)
+   {
+      if(!nOut[i]) continue;
+      if(!sorted_list[i]) { gate_list.push_back(new(_mem) UNDEFGate(i)); sorted_list[i] = gate_list.back(); }
+      sorted_list[i]->reserveOut(nOut[i], _mem);
+   }
+   // link gates in id order, which leaves each fanout list sorted
    for(int i = 0; i < header[0] + header[3] + 1; ++i)
    {
       if(sorted_list[i] == 0) continue;
       // cerr << "start linking (id : " << i << ") " << sorted_list[i]->getTypeStr() << endl;
       // cerr << "\tline no " << sorted_list[i]->getLineNo() << endl;
-      if(sorted_list[i]->getTypeInt() == AIG_GATE) combineAIG(sorted_list[i]->getLineNo() - 2);
-      else if(sorted_list[i]->getTypeInt() == PO_GATE) combinePO(sorted_list[i]->getLineNo() - 2);
+      if(sorted_list[i]->getTypeInt() == AIG_GATE)
+      {
+         const int* lit = &aigLits[3 * (sorted_list[i]->getLineNo() - aigLine)];
+         combineAIG(i, lit[1], lit[2]);
+      }
+      else if(sorted_list[i]->getTypeInt() == PO_GATE) combinePO(i, poLits[sorted_list[i]->getLineNo() - poLine]);
    }
    updateDfsList();
    return true;
@@ -479,43 +712,131 @@ CirMgr::updateDfsList()
 {
    CirGate::resetMark();
    _dfsList.clear();
+   _simView.clear();
+   _fecInit = false;
+   _fecGrps.clear();
    for(size_t i = 0; i < sorted_list.size(); ++i)
    {
       if(!sorted_list[i]) continue;
       if(sorted_list[i]->getTypeInt() == PO_GATE)
          sorted_list[i]->dfs(_dfsList);
    }
+   _inDfs.assign(sorted_list.size(), false);
+   for(size_t i = 0; i < _dfsList.size(); ++i) _inDfs[_dfsList[i]] = true;
+   for(size_t i = 0; i < _poList.size(); ++i) _inDfs[_poList[i]->getId()] = true;
+   _dfsDead = 0;
+}
+
+// "g" has just been merged into "rep" and detached from its fanins.
+// Drop it from the DFS order, with every AIG left without a fanout in the
+// order, and bring back "rep" and its fanins if they had been dropped
+// earlier in this command (they still hold their place in _dfsList).
+// Merging only ever redirects fanouts to a gate that precedes them, so the
+// order stays topological and no new DFS is needed.
+void
+CirMgr::mergeInDfs(CirGate* g, CirGate* rep)
+{
+   if(!_inDfs[g->getId()]) return;
+   GateList stack(1, rep);
+   while(!stack.empty())
+   {
+      CirGate* h = stack.back(); stack.pop_back();
+      if(!h->isAig() || _inDfs[h->getId()]) continue;
+      _inDfs[h->getId()] = true; --_dfsDead;
+      for(int i = 0; i < 2; ++i) stack.push_back(h->getIn(i));
+   }
+   stack.push_back(g);
+   while(!stack.empty())
+   {
+      g = stack.back(); stack.pop_back();
+      if(!_inDfs[g->getId()]) continue;
+      _inDfs[g->getId()] = false; ++_dfsDead;
+      for(int i = 0; i < 2; ++i)
+      {
+         CirGate* in = g->getIn(i);
+         if(!in || !in->isAig() || !_inDfs[in->getId()]) continue;
+         bool used = false;
+         for(size_t j = 0; j < in->getOutSize() && !used; ++j) used = _inDfs[in->getOut(j)->getId()];
+         if(!used) stack.push_back(in);
+      }
+   }
+}
+
+// Structural hashing of a new AND of lit0 and lit1 (gate literals): return
+// the literal of an existing equivalent node, by the constant and
+// idempotence rules of optimize() or from _strash; otherwise "id" is
+// entered into _strash for it and id << 1 is returned
+unsigned
+CirMgr::hashAnd(unsigned lit0, unsigned lit1, unsigned id)
+{
+   if(lit0 > lit1) { unsigned t = lit0; lit0 = lit1; lit1 = t; }
+   if(lit0 == 0 || lit0 == (lit1 ^ 1)) return 0;
+   if(lit0 == 1 || lit0 == lit1) return lit1;
+   return _strash.insert(lit0, lit1, id) << 1;
 }
 
-void CirMgr::combineAIG(unsigned value_num)
+// Merge "g" into "rep" (inverted if inv) and remove it from the circuit.
+// The fanouts of "g" get new fanin literals, so they are hashed again;
+// one that now duplicates another gate is left out of _strash, and the
+// next strash() merges it.
+void
+CirMgr::mergeGate(CirGate* g, CirGate* rep, bool inv, const string& op)
 {
-   // cerr << "value num : " << value_num << endl;
-   // for(size_t i = 0; i < value[value_num].size(); ++i) cerr << "value[" << value_num << "][" << i << "] " << value[value_num][i] << endl;
-   CirGate* inGate1 = getGate(value[value_num][1] / 2);
-   CirGate* inGate2 = getGate(value[value_num][2] / 2);
-   if(!inGate1) { inGate1 = new UNDEFGate(value[value_num][1] / 2); gate_list.push_back(inGate1); sorted_list[value[value_num][1] / 2] = inGate1; }
-   if(!inGate2) { inGate2 = new UNDEFGate(value[value_num][2] / 2); gate_list.push_back(inGate2); sorted_list[value[value_num][2] / 2] = inGate2; }
-   sorted_list[value[value_num][0] / 2]->setInGate(inGate1, inGate2, value[value_num][1] % 2, value[value_num][2] % 2);
-   inGate1->setOutGate(sorted_list[value[value_num][0] / 2], value[value_num][1] % 2);
-   inGate2->setOutGate(sorted_list[value[value_num][0] / 2], value[value_num][2] % 2);
+   GateList outs;
+   if(!_strash.empty())
+   {
+      if(g->isAig()) _strash.erase(g->getInLit(0), g->getInLit(1), g->getId());
+      for(size_t i = 0; i < g->getOutSize(); ++i)
+      {
+         CirGate* out = g->getOut(i);
+         if(!out->isAig()) continue;
+         _strash.erase(out->getInLit(0), out->getInLit(1), out->getId());
+         outs.push_back(out);
+      }
+   }
+   g->merge(rep, inv, op, _mem);
+   for(size_t i = 0; i < outs.size(); ++i)
+      _strash.insert(outs[i]->getInLit(0), outs[i]->getInLit(1), outs[i]->getId());
+   mergeInDfs(g, rep);
+   sorted_list[g->getId()] = 0;
 }
 
-void CirMgr::combinePO(unsigned value_num)
+// Squeeze the dropped entries out of _dfsList at the end of a command;
+// the flat views of the old netlist are invalid from here on
+void
+CirMgr::compactDfsList()
 {
-   CirGate* aigGate = getGate(value[value_num][1] / 2);
-   // cout << "aigGate : " << aigGate << endl;
-   if(!aigGate) { aigGate = new UNDEFGate(value[value_num][1] / 2); gate_list.push_back(aigGate); sorted_list[value[value_num][1] / 2] = aigGate; }
-   sorted_list[value[value_num][0]]->setInGate(aigGate, 0,  value[value_num][1] % 2, false);
-   aigGate->setOutGate(sorted_list[value[value_num][0]], value[value_num][1] % 2);
+   _simView.clear();
+   _fecInit = false;
+   _fecGrps.clear();
+   if(!_dfsDead) return;
+   size_t n = 0;
+   for(size_t i = 0; i < _dfsList.size(); ++i)
+      if(_inDfs[_dfsList[i]]) _dfsList[n++] = _dfsList[i];
+   _dfsList.resize(n);
+   _dfsDead = 0;
+}
+
+void CirMgr::combineAIG(unsigned id, int lit1, int lit2)
+{
+   CirGate* inGate1 = getGate(lit1 / 2);
+   CirGate* inGate2 = getGate(lit2 / 2);
+   sorted_list[id]->setInGate(inGate1, inGate2, lit1 % 2, lit2 % 2);
+   inGate1->setOutGate(sorted_list[id], lit1 % 2, _mem);
+   inGate2->setOutGate(sorted_list[id], lit2 % 2, _mem);
+}
+
+void CirMgr::combinePO(unsigned id, int lit)
+{
+   CirGate* aigGate = getGate(lit / 2);
+   sorted_list[id]->setInGate(aigGate, 0, lit % 2, false);
+   aigGate->setOutGate(sorted_list[id], lit % 2, _mem);
 }
 
 void CirMgr::linkSymbol(bool in, size_t gate_num, string sym)
 {
-   CirGate* control_gate;;
-   if(in) control_gate = getGate(value[gate_num][0] / 2);
-   else control_gate = getGate(value[gate_num + header[1] + header[2]][0]);
-   control_gate->setSymbol(sym);
-   // cerr << "set symbol " << sym << " to " << control_gate->getTypeStr() << " gate [" << control_gate->getId() << "]" << endl;
+   if(in) _piList[gate_num]->setSymbol(sym, _mem);
+   else _poList[gate_num]->setSymbol(sym, _mem);
 }
 
 /**********************************************************/
@@ -619,7 +940,23 @@ CirMgr::printFloatGates() const
 void
 CirMgr::printFECPairs() const
 {
-   // TODO
+   for(size_t i = 0; i < _fecGrps.size(); ++i)
+   {
+      cout << "[" << i << "]";
+      for(size_t j = 0; j < _fecGrps[i].size(); ++j)
+      {
+         cout << " ";
+         if((_fecGrps[i][j] & 1) != (_fecGrps[i][0] & 1)) cout << "!";
+         cout << (_fecGrps[i][j] >> 1);
+      }
+      cout << endl;
+   }
+}
+
+void
+CirMgr::printFEC() const
+{
+   cout << "Total #FEC Group = " << _fecGrps.size() << endl;
 }
 
 void
@@ -627,43 +964,53 @@ CirMgr::writeAag(ostream& outfile) const
 {
    // header
    outfile << "aag " << header[0] << " " << header[1] << " " << header[2] << " " << header[3] << " " << _dfsList.size() << endl;
-   // cout << "aag " << header[0] << " " << header[1] << " " << header[2] << " " << header[3] << " " << cnt << endl;
    // PI and PO
-   for(int i = 0; i < header[1] + header[2] + header[3]; ++i)
-   {
-      outfile << value[i].back();
-      outfile << endl;
-      // cout << value[i].back();
-      // cout << endl;
-   }
+   for(size_t i = 0; i < _piList.size(); ++i) outfile << 2 * _piList[i]->getId() << "\n";
+   for(size_t i = 0; i < _poList.size(); ++i)
+      outfile << 2 * _poList[i]->getIn(0)->getId() + _poList[i]->fanin_inv(0) << "\n";
    // AIG gate
    for(size_t i = 0; i < _dfsList.size(); ++i)
    {
-      for(size_t j = 0; j < value[sorted_list[_dfsList[i]]->getLineNo() - 2].size(); ++j)
-      {
-         if(j != 0) { outfile << " "; /*cout << " ";*/ }
-         outfile << value[sorted_list[_dfsList[i]]->getLineNo() - 2][j];
-         // cout << value[sorted_list[_dfsList[i]]->getLineNo() - 2][j];
-      }
-      outfile << endl;
-      // cout << endl;
+      CirGate* g = sorted_list[_dfsList[i]];
+      outfile << 2 * g->getId() << " " << 2 * g->getIn(0)->getId() + g->fanin_inv(0)
+              << " " << 2 * g->getIn(1)->getId() + g->fanin_inv(1) << "\n";
    }
    //symbol
-   for(size_t i = 0; i < sorted_list.size(); ++i)
+   for(size_t i = 0; i < _piList.size(); ++i)
+      if(_piList[i]->getSymbol().size()) outfile << "i" << i << " " << _piList[i]->getSymbol() << "\n";
+   for(size_t i = 0; i < _poList.size(); ++i)
+      if(_poList[i]->getSymbol().size()) outfile << "o" << i << " " << _poList[i]->getSymbol() << "\n";
+   outfile << "c\nAAG output by Chung-Yang (Ric) Huang" << endl;
+}
+
+// Binary AIGER: PIs are renumbered 1~I in file order and the AIGs in
+// _dfsList get I+1, I+2, ..., so every fanin has a smaller literal.
+// Undefined fanins are written as CONST 0, as they are simulated.
+void
+CirMgr::writeAig(ostream& outfile) const
+{
+   vector<size_t> var(sorted_list.size(), 0);
+   size_t M = _piList.size();
+   for(size_t i = 0; i < _piList.size(); ++i) var[_piList[i]->getId()] = i + 1;
+   for(size_t i = 0; i < _dfsList.size(); ++i) var[_dfsList[i]] = ++M;
+   outfile << "aig " << M << " " << _piList.size() << " 0 " << _poList.size() << " " << _dfsList.size() << "\n";
+   for(size_t i = 0; i < _poList.size(); ++i)
+      outfile << 2 * var[_poList[i]->getIn(0)->getId()] + _poList[i]->fanin_inv(0) << "\n";
+   for(size_t i = 0; i < _dfsList.size(); ++i)
    {
-      if(sorted_list[i] == 0) continue;
-      if(sorted_list[i]->getTypeInt() == PO_GATE)
-      {
-         if(sorted_list[i]->getSymbol().size())
-            outfile << "i" << i << " " << sorted_list[i]->getSymbol() << endl;
-      }
-      else if(sorted_list[i]->getTypeInt() == PI_GATE)
-      {
-         if(sorted_list[i]->getSymbol().size())
-            outfile << "o" << i - header[1] - header[2] << " " << sorted_list[i]->getSymbol() << endl;
-      }
+      CirGate* g = sorted_list[_dfsList[i]];
+      size_t lhs = 2 * var[_dfsList[i]];
+      size_t rhs0 = 2 * var[g->getIn(0)->getId()] + g->fanin_inv(0);
+      size_t rhs1 = 2 * var[g->getIn(1)->getId()] + g->fanin_inv(1);
+      if(rhs0 < rhs1) swap(rhs0, rhs1);
+      writeUInt(outfile, lhs - rhs0);
+      writeUInt(outfile, rhs0 - rhs1);
    }
-   outfile << "c\nAAG output by Chung-Yang (Ric) Huang" << endl; 
+   for(size_t i = 0; i < _piList.size(); ++i)
+      if(_piList[i]->getSymbol().size()) outfile << "i" << i << " " << _piList[i]->getSymbol() << "\n";
+   for(size_t i = 0; i < _poList.size(); ++i)
+      if(_poList[i]->getSymbol().size()) outfile << "o" << i << " " << _poList[i]->getSymbol() << "\n";
+   outfile << "c\nAAG output by Chung-Yang (Ric) Huang" << endl;
 }
 
 void
@@ -19,6 +19,10 @@ using namespace std;
 // TODO: Feel free to define your own classes, variables, or functions.
 
 #include "cirDef.h"
+#include "cirSimView.h"
+#include "cirMemMgr.h"
+#include "cirStrash.h"
+#include "cirThreadPool.h"
 
 extern CirMgr *cirMgr;
 
@@ -33,10 +37,14 @@ public:
    CirGate* getGate(unsigned gid) const { if(gid >= sorted_list.size()) return 0; return sorted_list[gid]; }
 
    // Member functions about circuit construction
-   bool readCircuit(const string&);
+   bool readCircuit(const string&, bool strash = false);
+   unsigned hashAnd(unsigned lit0, unsigned lit1, unsigned id);
    void updateDfsList();
-   void combineAIG(unsigned value_num);
-   void combinePO(unsigned value_num);
+   void mergeInDfs(CirGate* g, CirGate* rep);
+   void mergeGate(CirGate* g, CirGate* rep, bool inv, const string& op);
+   void compactDfsList();
+   void combineAIG(unsigned id, int lit1, int lit2);
+   void combinePO(unsigned id, int lit);
    void linkSymbol(bool in, size_t gate_num, string sym);
 
    // Member functions about circuit optimization
@@ -45,16 +53,36 @@ public:
    void optimize();
    void reduce2fanin(int num, size_t id);
    void reduce2Const(size_t id);
+   void balance();
+   unsigned levelize(vector<unsigned>& level) const;
+
+   // Member functions about rewriting
+   void rewrite();
+   void getFreeIds(IdList& freeIds) const;
+   unsigned addAnd(unsigned lit0, unsigned lit1, IdList& freeIds);
+   void removeDangling(CirGate* g);
+   void renumberPOs();
 
    // Member functions about simulation
    void randomSim();
    void fileSim(ifstream&);
    void setSimLog(ofstream *logFile) { _simLog = logFile; }
+   void setSimThreads(size_t n) { _simThreads = (n)? n : 1; }
+   void buildSimView();
+   bool simulateBlocks(vector<vector<SimWord> >& blocks, size_t n, size_t lastPatterns);
+   void writeSimLog(const SimWord* v, size_t patternNum, string& out) const;
+   bool refineFEC(const SimWord* v);
+   bool refineFEC(const vector<const SimWord*>& blocks);
+   void sortFEC();
 
    // Member functions about fraig
    void strash();
+   void fillStrash();
    void printFEC() const;
    void fraig();
+   void setFraigBudget(int n) { _fraigBudget = n; }
+   void setFraigThreads(size_t n) { _fraigThreads = (n)? n : 1; }
+   void removeFEC(const vector<bool>& done);
 
    // Member functions about circuit reporting
    void printSummary() const;
@@ -64,15 +92,27 @@ public:
    void printFloatGates() const;
    void printFECPairs() const;
    void writeAag(ostream&) const;
+   void writeAig(ostream&) const;
    void writeGate(ostream&, CirGate*) const;
 
 private:
    ofstream           *_simLog;
+   size_t              _simThreads;
+   int                 _fraigBudget;  // conflicts per SAT proof, < 0: no limit
+   size_t              _fraigThreads;
    int header[5];
 	size_t M, I, L, O, A;
-	vector<vector<size_t>> value;
+   CirMemMgr _mem;   // owns all the gates, fanout arrays and symbols
 	GateList gate_list, sorted_list;
+	GateList _piList, _poList; // in file order
    IdList _dfsList;
+   vector<bool> _inDfs;   // by gate id: an AIG in _dfsList, or a PO
+   size_t _dfsDead;       // entries of _dfsList dropped by mergeInDfs()
+   CirStrashTable _strash;   // filled by the first strash(), then kept up to date
+   CirSimView _simView;
+   CirThreadPool _pool;      // worker threads of cirsim and cirfraig
+   bool _fecInit;
+   vector<IdList> _fecGrps;   // FEC groups of (gate id << 1 | phase)
 };
 
 #endif // CIR_MGR_H
@@ -11,6 +11,7 @@
 #include "cirGate.h"
 #include "util.h"
 #include <algorithm>
+#include <functional>
 
 using namespace std;
 
@@ -59,18 +60,107 @@ CirMgr::removeGate(size_t id)
          CirGate* inGate2 = sorted_list[id]->getIn(1);
          inGate1->removeOut(id);
          inGate2->removeOut(id);
+         _strash.erase(sorted_list[id]->getInLit(0), sorted_list[id]->getInLit(1), id);
          cout << "Sweeping: AIG(" << id << ") removed..." << endl;
       }
       else cout << "Sweeping: UNDEF(" << id << ") removed..." << endl;
       sorted_list[id] = 0;
    }
 }
+// Rebuild every AND supergate as a balanced tree. A supergate is an AIG
+// with the AIGs it absorbs: fanins reached by non-inverted edges that have
+// no other fanout. Its leaves are combined two by two, the earliest
+// arriving (lowest level) first, through addAnd(), so a pair that exists
+// already is shared instead of duplicated. Supergates are visited in
+// topological order, so their leaves are balanced before them.
+void
+CirMgr::balance()
+{
+   vector<unsigned> level;
+   unsigned before = levelize(level);
+   fillStrash();
+   IdList freeIds, order(_dfsList), leaves, stack;
+   getFreeIds(freeIds);
+   vector<pair<unsigned, unsigned> > heap;   // (level, literal), smallest level on top
+   for(size_t k = 0; k < order.size(); ++k)
+   {
+      CirGate* g = sorted_list[order[k]];
+      if(!g || !g->isAig()) continue;
+      if(g->getOutSize() == 1 && g->getOut(0)->isAig() && !g->fanout_inv(0)) continue;   // absorbed
+      leaves.clear();
+      stack.assign(1, g->getInLit(0)); stack.push_back(g->getInLit(1));
+      while(!stack.empty())
+      {
+         unsigned lit = stack.back(); stack.pop_back();
+         CirGate* in = sorted_list[lit >> 1];
+         if(!(lit & 1) && in->isAig() && in->getOutSize() == 1)
+         { stack.push_back(in->getInLit(0)); stack.push_back(in->getInLit(1)); }
+         else leaves.push_back(lit);
+      }
+      if(leaves.size() > 2)
+      {
+         sort(leaves.begin(), leaves.end());
+         leaves.erase(unique(leaves.begin(), leaves.end()), leaves.end());
+         unsigned out = 1;
+         heap.clear();
+         for(size_t i = 0; i < leaves.size() && out; ++i)
+         {
+            if(i && leaves[i] == (leaves[i - 1] ^ 1)) out = 0;
+            heap.push_back(make_pair(level[leaves[i] >> 1], leaves[i]));
+         }
+         make_heap(heap.begin(), heap.end(), greater<pair<unsigned, unsigned> >());
+         while(out && heap.size() > 1)
+         {
+            pop_heap(heap.begin(), heap.end(), greater<pair<unsigned, unsigned> >());
+            unsigned lit0 = heap.back().second; heap.pop_back();
+            pop_heap(heap.begin(), heap.end(), greater<pair<unsigned, unsigned> >());
+            unsigned lit1 = heap.back().second; heap.pop_back();
+            unsigned lit = addAnd(lit0, lit1, freeIds);
+            if(level.size() < sorted_list.size()) level.resize(sorted_list.size(), 0);
+            CirGate* h = sorted_list[lit >> 1];
+            if(h->isAig()) level[h->getId()] = std::max(level[lit0 >> 1], level[lit1 >> 1]) + 1;
+            heap.push_back(make_pair(level[lit >> 1], lit));
+            push_heap(heap.begin(), heap.end(), greater<pair<unsigned, unsigned> >());
+         }
+         if(out) out = heap[0].second;
+         if((out >> 1) != g->getId())
+         {
+            mergeGate(g, sorted_list[out >> 1], out & 1, "Balancing");
+            removeDangling(g);
+            continue;
+         }
+      }
+      level[g->getId()] = std::max(level[g->getIn(0)->getId()], level[g->getIn(1)->getId()]) + 1;
+   }
+   renumberPOs();
+   updateDfsList();
+   unsigned after = levelize(level);
+   cout << "Balancing: depth " << before << " -> " << after << endl;
+}
+
+// The level of every gate in _dfsList (PIs and CONST are at 0) into
+// "level", indexed by gate id; return the largest level of a PO fanin
+unsigned
+CirMgr::levelize(vector<unsigned>& level) const
+{
+   level.assign(sorted_list.size(), 0);
+   for(size_t i = 0; i < _dfsList.size(); ++i)
+   {
+      CirGate* g = sorted_list[_dfsList[i]];
+      level[g->getId()] = std::max(level[g->getIn(0)->getId()], level[g->getIn(1)->getId()]) + 1;
+   }
+   unsigned depth = 0;
+   for(size_t i = 0; i < _poList.size(); ++i)
+      depth = std::max(depth, level[_poList[i]->getIn(0)->getId()]);
+   return depth;
+}
+
 /***************************************************/
 /*   Private member functions about optimization   */
 /***************************************************/
 
 // Recursively simplifying from POs;
-// _dfsList needs to be reconstructed afterwards
+// _dfsList is updated gate by gate and compacted afterwards
 // UNDEF gates may be delete if its fanout becomes empty...
 
 void
@@ -107,71 +197,21 @@ CirMgr::optimize()
       }
    }
 
-   updateDfsList();
+   compactDfsList();
 }
 
+// Both merge the gate away with mergeGate(), which keeps _dfsList and
+// _strash in step
 void
 CirMgr::reduce2fanin(int num, size_t id)
 {
    CirGate* InGate = (sorted_list[id]->getIn(0)->getId() != 0)? sorted_list[id]->getIn(0) : sorted_list[id]->getIn(1);
-   bool inv = sorted_list[id]->fanin_inv(num);
-   GateList outList;
-   vector<bool> out_inv;
-   for(size_t i = 0; i < sorted_list[id]->getOutSize(); ++i)
-   {
-      outList.push_back(sorted_list[id]->getOut(i));
-      out_inv.push_back(sorted_list[id]->fanout_inv(i));
-   }
-
-   InGate->removeOut(id);
-   for(size_t i = 0; i < outList.size(); ++i)
-   {
-      // cerr << "id " << outList[i]->getId() << " inv : " << out_inv[i] << endl;
-      outList[i]->setInGate(outList[i]->findIn(id), InGate, (out_inv[i] == inv)? false : true) ;
-      InGate->setOutGate(outList[i], (out_inv[i] == inv)? false : true);
-   }
-   sorted_list[id] = 0;
-   // cerr << "change id " << id << " to id " << InGate->getId() << endl;
-   // cerr << "==================================================" << endl;
-   cout << "Simplifying: " << InGate->getId() << " merging ";
-   if(inv) cout << "!";
-   cout << id << "..." << endl;
+   mergeGate(sorted_list[id], InGate, sorted_list[id]->fanin_inv(num), "Simplifying");
 }
 
 void
 CirMgr::reduce2Const(size_t id)
 {
-   CirGate* InGate1 = sorted_list[id]->getIn(0);
-   CirGate* InGate2 = sorted_list[id]->getIn(1);
-   // cerr << "inGate1 : " << sorted_list[id]->getIn(0)-> getId() << " (inv : " << sorted_list[id]->fanin_inv(0) << ")" << endl;
-   // cerr << "inGate2 : " << sorted_list[id]->getIn(1)-> getId() << " (inv : " << sorted_list[id]->fanin_inv(1) << ")" << endl;
-   GateList outList;
-   vector<bool> out_inv;
-   for(size_t i = 0; i < sorted_list[id]->getOutSize(); ++i)
-   {
-      outList.push_back(sorted_list[id]->getOut(i));
-      out_inv.push_back(sorted_list[id]->fanout_inv(i));
-   }
-   // cerr << "id " << id << " out list : " << endl;
-   // for(size_t i = 0; i < outList.size(); ++i) cerr << "\t" << outList[i]->getId() << endl;
-   InGate1->removeOut(id);
-   InGate2->removeOut(id);
-   for(size_t i = 0; i < outList.size(); ++i)
-   {
-      // cerr << "origin inGate of gate id " << outList[i]->getId() << endl;
-      // for(size_t j = 0; j < 2; ++j) cerr << outList[i]->getIn(j)->getId() << endl;
-      // cerr << endl;
-      // cerr << "id " << outList[i]->getId() << " set inGate " << outList[i]->findIn(id) << " to const " << inv << endl;
-      outList[i]->setInGate(outList[i]->findIn(id), sorted_list[0], out_inv[i]);
-      sorted_list[0]->setOutGate(outList[i], out_inv[i]);
-      // cerr << "after set inGate of gate id " << outList[i]->getId() << endl;
-      // for(size_t j = 0; j < 2; ++j) cerr << outList[i]->getIn(j)->getId() << " (inv : " << outList[i]->getIn(j)->fanin_inv(j) << " )" << endl;
-      // cerr << endl;
-   }
-   sorted_list[id] = 0;
-   // cerr << "change id " << id << " to const " << inv << endl;
-   // cerr << "==================================================" << endl;
-   cout << "Simplifying: 0 merging ";
-   cout << id << "..." << endl;
+   mergeGate(sorted_list[id], sorted_list[0], false, "Simplifying");
 }
 
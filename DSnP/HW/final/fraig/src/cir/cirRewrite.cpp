@@ -0,0 +1,279 @@
+/****************************************************************************
+  FileName     [ cirRewrite.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define cut-based AIG rewriting ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <cassert>
+#include <algorithm>
+#include "cirMgr.h"
+#include "cirGate.h"
+#include "cirCut.h"
+#include "util.h"
+
+using namespace std;
+
+/*******************************/
+/*   Global variable and enum  */
+/*******************************/
+enum RwParam
+{
+   RW_CUT_SIZE  = 4,   // leaves of a cut
+   RW_CUT_LIMIT = 8    // cuts kept per gate
+};
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+static const unsigned short varMask[RW_CUT_SIZE] = { 0xAAAA, 0xCCCC, 0xF0F0, 0xFF00 };
+
+static inline unsigned short
+cofactor0(unsigned short t, int v)
+{
+   t &= ~varMask[v];
+   return t | (t << (1 << v));
+}
+
+static inline unsigned short
+cofactor1(unsigned short t, int v)
+{
+   t &= varMask[v];
+   return t | (t >> (1 << v));
+}
+
+// Minato-Morreale ISOP: append to "cubes" an irredundant sum of products
+// c with L <= c <= U over the variables below n, and return c.
+// A cube has bit v set for variable v and bit v + 4 for its complement.
+static unsigned short
+isop(unsigned short L, unsigned short U, int n, vector<unsigned char>& cubes)
+{
+   if(!L) return 0;
+   if(U == 0xFFFF) { cubes.push_back(0); return 0xFFFF; }
+   int v = n - 1;
+   while(v >= 0 && cofactor0(L, v) == cofactor1(L, v) && cofactor0(U, v) == cofactor1(U, v)) --v;
+   assert(v >= 0);
+   unsigned short L0 = cofactor0(L, v), L1 = cofactor1(L, v);
+   unsigned short U0 = cofactor0(U, v), U1 = cofactor1(U, v);
+   size_t b0 = cubes.size();
+   unsigned short f0 = isop(L0 & ~U1, U0, v, cubes);
+   size_t b1 = cubes.size();
+   unsigned short f1 = isop(L1 & ~U0, U1, v, cubes);
+   size_t b2 = cubes.size();
+   unsigned short fs = isop((L0 & ~f0) | (L1 & ~f1), U0 & U1, v, cubes);
+   for(size_t i = b0; i < b1; ++i) cubes[i] |= 1 << (v + 4);
+   for(size_t i = b1; i < b2; ++i) cubes[i] |= 1 << v;
+   return (f0 & ~varMask[v]) | (f1 & varMask[v]) | fs;
+}
+
+// Build the cover on the leaf literals with "andLit" (a two-literal AND
+// returning a literal); the OR of the cubes is built as an inverted AND
+template <class AndLit> static unsigned
+buildCover(const vector<unsigned char>& cubes, const unsigned* leafLit, int n, AndLit andLit)
+{
+   unsigned out = 0;
+   for(size_t i = 0; i < cubes.size(); ++i)
+   {
+      unsigned cube = 1;
+      for(int v = 0; v < n; ++v)
+      {
+         if(cubes[i] & (1 << v)) cube = andLit(cube, leafLit[v]);
+         if(cubes[i] & (1 << (v + 4))) cube = andLit(cube, leafLit[v] ^ 1);
+      }
+      out = andLit(out ^ 1, cube ^ 1) ^ 1;
+   }
+   return out;
+}
+
+/************************************************/
+/*   Public member functions about rewriting    */
+/************************************************/
+// DAG-aware rewriting: for every AIG in _dfsList, each 4-input cut is
+// resynthesized from the ISOP of its truth table (or of its complement),
+// built on _strash so existing gates are shared. The best cut replaces the
+// gate if the new gates are fewer than the gates freed with it (its MFFC
+// within the cut). Gates are visited in topological order, so the cuts of
+// a gate already see the rewritten fanins; the gates a replacement is
+// built from get their cuts right away.
+void
+CirMgr::rewrite()
+{
+   fillStrash();
+   IdList freeIds;
+   getFreeIds(freeIds);
+
+   // cuts are not dropped: a replacement may be built on any earlier gate,
+   // and its fanouts need the cuts through it
+   CirCutMgr cutMgr(RW_CUT_SIZE, RW_CUT_LIMIT);
+   cutMgr.init(sorted_list.size() - 1);
+   IdList order(_dfsList), mffc;
+   vector<pair<unsigned, unsigned> > refs;   // fanouts left while dereferencing
+   vector<unsigned char> cover, bestCover;
+   for(size_t k = 0; k < order.size(); ++k)
+   {
+      CirGate* g = sorted_list[order[k]];
+      if(!g || !g->isAig()) continue;
+      if(!cutMgr.hasCuts(g->getId())) cutMgr.compute(g);
+      int bestGain = 0;
+      CirCut best;
+      bool bestInv = false;
+      for(size_t c = 0; c < cutMgr.numCuts(g->getId()); ++c)
+      {
+         const CirCut& cut = cutMgr.cut(g->getId(), c);
+         bool dead = false;
+         for(unsigned i = 0; i < cut._size; ++i) dead |= !sorted_list[cut._leaf[i]];
+         if(dead) continue;
+         // the MFFC: gates that lose all their fanouts with "g", up to the leaves
+         mffc.assign(1, g->getId());
+         refs.clear();
+         for(size_t m = 0; m < mffc.size(); ++m)
+            for(int i = 0; i < 2; ++i)
+            {
+               CirGate* in = sorted_list[mffc[m]]->getIn(i);
+               if(!in->isAig() || find(cut._leaf, cut._leaf + cut._size, in->getId()) != cut._leaf + cut._size) continue;
+               size_t r = 0;
+               while(r < refs.size() && refs[r].first != in->getId()) ++r;
+               if(r == refs.size()) refs.push_back(make_pair(in->getId(), in->getOutSize()));
+               if(--refs[r].second == 0) mffc.push_back(in->getId());
+            }
+         unsigned leafLit[RW_CUT_SIZE];
+         for(unsigned i = 0; i < cut._size; ++i) leafLit[i] = cut._leaf[i] << 1;
+         for(int inv = 0; inv < 2; ++inv)
+         {
+            unsigned short tt = (inv)? ~cut.tt16() : cut.tt16();
+            cover.clear();
+            isop(tt, tt, cut._size, cover);
+            // dry run: count the gates to be added, and the MFFC gates reused
+            int cost = 0;
+            unsigned fake = sorted_list.size();
+            vector<pair<unsigned long long, unsigned> > added;   // pairs given fake ids
+            IdList reused;
+            auto dryAnd = [&](unsigned lit0, unsigned lit1) -> unsigned {
+               if(lit0 > lit1) swap(lit0, lit1);
+               if(lit0 == 0 || lit0 == (lit1 ^ 1)) return 0;
+               if(lit0 == 1 || lit0 == lit1) return lit1;
+               unsigned id;
+               if(_strash.query(lit0, lit1, id) && sorted_list[id])
+               {
+                  if(id == g->getId()) cost += mffc.size();   // nothing is freed
+                  else if(find(mffc.begin(), mffc.end(), id) != mffc.end()
+                       && find(reused.begin(), reused.end(), id) == reused.end())
+                  { reused.push_back(id); ++cost; }
+                  return id << 1;
+               }
+               unsigned long long key = ((unsigned long long)lit0 << 32) | lit1;
+               for(size_t i = 0; i < added.size(); ++i)
+                  if(added[i].first == key) return added[i].second;
+               ++cost;
+               added.push_back(make_pair(key, fake << 1));
+               return fake++ << 1;
+            };
+            unsigned out = buildCover(cover, leafLit, cut._size, dryAnd);
+            if((out >> 1) == g->getId()) continue;
+            int gain = int(mffc.size()) - cost;
+            if(gain > bestGain) { bestGain = gain; best = cut; bestCover = cover; bestInv = inv; }
+         }
+      }
+      if(!bestGain) continue;
+      unsigned leafLit[RW_CUT_SIZE];
+      for(unsigned i = 0; i < best._size; ++i) leafLit[i] = best._leaf[i] << 1;
+      auto realAnd = [&](unsigned lit0, unsigned lit1) -> unsigned {
+         unsigned lit = addAnd(lit0, lit1, freeIds);
+         CirGate* h = sorted_list[lit >> 1];
+         if(h->isAig() && !cutMgr.hasCuts(h->getId())) cutMgr.compute(h);
+         return lit;
+      };
+      unsigned out = buildCover(bestCover, leafLit, best._size, realAnd) ^ unsigned(bestInv);
+      mergeGate(g, sorted_list[out >> 1], out & 1, "Rewriting");
+      removeDangling(g);
+   }
+   renumberPOs();
+   updateDfsList();
+}
+
+// The ids below M that are free, for addAnd() to give out smallest first
+void
+CirMgr::getFreeIds(IdList& freeIds) const
+{
+   freeIds.clear();
+   for(int i = header[0]; i > 0; --i) if(!sorted_list[i]) freeIds.push_back(i);
+}
+
+// The literal of lit0 & lit1, hashed like hashAnd(); a new AIG gate takes
+// the smallest id in "freeIds", or one above all the others (even the POs;
+// see renumberPOs())
+unsigned
+CirMgr::addAnd(unsigned lit0, unsigned lit1, IdList& freeIds)
+{
+   if(lit0 > lit1) swap(lit0, lit1);
+   if(lit0 == 0 || lit0 == (lit1 ^ 1)) return 0;
+   if(lit0 == 1 || lit0 == lit1) return lit1;
+   unsigned id;
+   if(_strash.query(lit0, lit1, id) && sorted_list[id]) return id << 1;
+   if(!freeIds.empty()) { id = freeIds.back(); freeIds.pop_back(); }
+   else
+   {
+      id = sorted_list.size();
+      sorted_list.push_back(0);
+      _inDfs.push_back(false);
+   }
+   CirGate* g = new(_mem) AIGGate(id, 0);
+   sorted_list[id] = g;
+   CirGate* in0 = sorted_list[lit0 >> 1];
+   CirGate* in1 = sorted_list[lit1 >> 1];
+   g->setInGate(in0, in1, lit0 & 1, lit1 & 1);
+   in0->setOutGate(g, lit0 & 1, _mem);
+   in1->setOutGate(g, lit1 & 1, _mem);
+   _strash.replace(lit0, lit1, id);
+   return id << 1;
+}
+
+// "g" has been merged away; remove, without a report, the AIG gates in its
+// fanin cone that are left without fanouts
+void
+CirMgr::removeDangling(CirGate* g)
+{
+   GateList stack(1, g);
+   while(!stack.empty())
+   {
+      CirGate* h = stack.back(); stack.pop_back();
+      for(int i = 0; i < 2; ++i)
+      {
+         CirGate* in = h->getIn(i);
+         if(!in || !in->isAig() || in->getOutSize() || !sorted_list[in->getId()]) continue;
+         _strash.erase(in->getInLit(0), in->getInLit(1), in->getId());
+         for(int j = 0; j < 2; ++j) in->getIn(j)->removeOut(in->getId());
+         sorted_list[in->getId()] = 0;
+         stack.push_back(in);
+      }
+   }
+}
+
+// AIGER numbers the POs M+1 ~ M+O. After gates have been added above them
+// by addAnd() or removed, M becomes the largest id of the other gates and
+// the POs follow it again, in their order.
+void
+CirMgr::renumberPOs()
+{
+   int m = 0;
+   for(size_t i = 0; i < sorted_list.size(); ++i)
+      if(sorted_list[i] && sorted_list[i]->getTypeInt() != PO_GATE) m = i;
+   if(m == header[0] && sorted_list.size() == size_t(m + header[3] + 1)) return;
+   // the old ids may clash with the new ones, so take every PO out of its
+   // fanin's (id sorted) fanout list first
+   for(size_t i = 0; i < _poList.size(); ++i)
+   {
+      _poList[i]->getIn(0)->removeOut(_poList[i]->getId());
+      sorted_list[_poList[i]->getId()] = 0;
+   }
+   sorted_list.resize(m + header[3] + 1, 0);
+   for(size_t i = 0; i < _poList.size(); ++i)
+   {
+      CirGate* po = _poList[i];
+      po->setId(m + i + 1);
+      sorted_list[m + i + 1] = po;
+      po->getIn(0)->setOutGate(po, po->fanin_inv(0), _mem);
+   }
+   header[0] = m;
+}
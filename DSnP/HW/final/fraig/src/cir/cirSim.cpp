@@ -11,6 +11,7 @@
 #include <iomanip>
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include "cirMgr.h"
 #include "cirGate.h"
 #include "util.h"
@@ -27,6 +28,113 @@ using namespace std;
 /**************************************/
 /*   Static varaibles and functions   */
 /**************************************/
+// "cirsim -random" stops once this many patterns in a row split no FEC group
+static const size_t randomSimStallPatterns = 4096;
+
+// rnGen only gives ~31 random bits per call
+static size_t
+randomWord()
+{
+   return (size_t(rnGen(INT_MAX)) << 33) ^ (size_t(rnGen(INT_MAX)) << 16) ^ size_t(rnGen(INT_MAX));
+}
+
+// xorshift64* generator; each simulation thread draws its patterns from its
+// own one, seeded from rnGen, since rnGen is not thread-safe
+class SimRandom
+{
+public:
+   SimRandom(size_t seed) : _s(seed? seed : 0x9E3779B97F4A7C15ULL) {}
+
+   SimWord operator() ()
+   {
+      SimWord v;
+      for(size_t i = 0; i < SimWord::WORDS; ++i)
+      {
+         _s ^= _s >> 12; _s ^= _s << 25; _s ^= _s >> 27;
+         v[i] = _s * 0x2545F4914F6CDD1DULL;
+      }
+      return v;
+   }
+
+private:
+   size_t _s;
+};
+
+// HashMap key of a (phase-normalized) simulation signature
+class SimKey
+{
+public:
+   SimKey(const SimWord& v) : _v(v) {}
+
+   size_t operator() () const
+   {
+      size_t h = 0;
+      for(size_t i = 0; i < SimWord::WORDS; ++i) h = (h ^ _v[i]) * 0x9E3779B97F4A7C15ULL;
+      return h ^ (h >> 32);
+   }
+   bool operator == (const SimKey& k) const { return _v == k._v; }
+
+private:
+   SimWord _v;
+};
+
+// signature of "lit" (gate id << 1 | phase) in block "v", complemented if
+// the phase is set
+static inline SimWord
+memberSig(const CirSimView& view, const SimWord* v, unsigned lit)
+{
+   const SimWord& w = v[view.index(lit >> 1)];
+   return (lit & 1)? ~w : w;
+}
+
+// Split "grp" by its signatures in all the blocks, block by block, and
+// append the parts with two or more members to "out". The phase of every
+// member is fixed by pattern 0 of the first block. Return true if "grp" was
+// split.
+static bool
+splitFECGroup(IdList& grp, const vector<const SimWord*>& blocks, const CirSimView& view,
+              vector<IdList>& out)
+{
+   for(size_t i = 0, n = grp.size(); i < n; ++i)
+      grp[i] = (grp[i] & ~1U) | unsigned(blocks[0][view.index(grp[i] >> 1)].bit(0));
+   bool split = false;
+   vector<IdList> parts(1), next;
+   parts[0].swap(grp);
+   for(size_t b = 0, nb = blocks.size(); b < nb && !parts.empty(); ++b)
+   {
+      const SimWord* v = blocks[b];
+      next.clear();
+      for(size_t p = 0, np = parts.size(); p < np; ++p)
+      {
+         IdList& part = parts[p];
+         // most groups do not split; check that first without hashing
+         SimWord s0 = memberSig(view, v, part[0]);
+         size_t same = 1;
+         for(size_t n = part.size(); same < n; ++same)
+            if(memberSig(view, v, part[same]) != s0) break;
+         if(same == part.size()) { next.push_back(IdList()); next.back().swap(part); continue; }
+         split = true;
+         HashMap<SimKey, size_t> hash(getHashSize(part.size()));
+         size_t first = next.size();
+         for(size_t i = 0, n = part.size(); i < n; ++i)
+         {
+            SimKey k(memberSig(view, v, part[i]));
+            size_t pos;
+            if(hash.query(k, pos)) next[pos].push_back(part[i]);
+            else { hash.insert(k, next.size()); next.push_back(IdList(1, part[i])); }
+         }
+         // singletons are dropped at once
+         size_t kept = first;
+         for(size_t i = first, n = next.size(); i < n; ++i)
+            if(next[i].size() > 1) next[kept++].swap(next[i]);
+         next.resize(kept);
+      }
+      parts.swap(next);
+   }
+   for(size_t p = 0, np = parts.size(); p < np; ++p)
+      if(parts[p].size() > 1) { out.push_back(IdList()); out.back().swap(parts[p]); }
+   return split;
+}
 
 /************************************************/
 /*   Public member functions about Simulation   */
@@ -34,13 +142,238 @@ using namespace std;
 void
 CirMgr::randomSim()
 {
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   if(_simView.empty()) buildSimView();
+   // one round = one SimWord block per thread
+   size_t nThreads = _simThreads, nPi = _simView.numPi();
+   size_t roundPatterns = nThreads * SimWord::BITS;
+   size_t stallLimit = (randomSimStallPatterns + roundPatterns - 1) / roundPatterns;
+   size_t rounds = 0, stall = 0;
+   _pool.resize(nThreads);
+   vector<vector<SimWord> > blocks(nThreads, vector<SimWord>(_simView.size()));
+   vector<SimRandom> rng;
+   for(size_t t = 0; t < nThreads; ++t) rng.push_back(SimRandom(randomWord()));
+   while(stall < stallLimit)
+   {
+      _pool.run([&](size_t t) {
+         for(size_t i = 0; i < nPi; ++i) blocks[t][i + 1] = rng[t]();
+      });
+      bool split = simulateBlocks(blocks, nThreads, SimWord::BITS);
+      ++rounds;
+      if(_fecGrps.empty()) break;
+      stall = (split)? 0 : stall + 1;
+   }
+   sortFEC();
+   printFEC();
+   cout << rounds * roundPatterns << " patterns simulated." << endl;
+   cout << "Stopped after " << rounds << " rounds (" << nThreads << " thread" << ((nThreads > 1)? "s" : "")
+        << "), " << _fecGrps.size() << " FEC groups left, "
+        << chrono::duration<double>(chrono::steady_clock::now() - start).count() << " seconds." << endl;
 }
 
+// Patterns are read token by token and packed SimWord::BITS at a time into
+// one word per PI, so memory use does not depend on the size of the pattern
+// file. A round is simulated once there is a full block for every thread.
 void
 CirMgr::fileSim(ifstream& patternFile)
 {
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   if(_simView.empty()) buildSimView();
+   size_t nThreads = _simThreads, nPi = _piList.size();
+   _pool.resize(nThreads);
+   vector<vector<SimWord> > blocks(nThreads, vector<SimWord>(_simView.size()));
+   size_t patternNum = 0, nBlocks = 0, bit = 0;
+   string pattern;
+   bool error = false;
+   while(!error && patternFile >> pattern)
+   {
+      if(pattern.size() != nPi)
+      {
+         cerr << "Error: Pattern(" << pattern << ") length(" << pattern.size()
+              << ") does not match the number of inputs(" << nPi
+              << ") in a circuit!!" << endl;
+         error = true; break;
+      }
+      SimWord* piWords = &blocks[nBlocks][1];
+      for(size_t i = 0; i < nPi; ++i)
+      {
+         if(pattern[i] == '1') piWords[i].setBit(bit);
+         else if(pattern[i] != '0')
+         {
+            cerr << "Error: Pattern(" << pattern << ") contains a non-0/1 character('"
+                 << pattern[i] << "')." << endl;
+            error = true; break;
+         }
+      }
+      if(error || ++bit != SimWord::BITS) continue;
+      bit = 0;
+      if(++nBlocks != nThreads) continue;
+      simulateBlocks(blocks, nBlocks, SimWord::BITS);
+      patternNum += nBlocks * SimWord::BITS;
+      for(size_t t = 0; t < nBlocks; ++t)
+         for(size_t i = 0; i < nPi; ++i) blocks[t][i + 1] = SimWord();
+      nBlocks = 0;
+   }
+   // the last partial word; it is dropped if the file has a bad pattern
+   size_t lastPatterns = SimWord::BITS;
+   if(!error && bit)
+   {
+      // pad the unused patterns with copies of pattern 0 so they cannot split groups
+      SimWord* piWords = &blocks[nBlocks][1];
+      for(size_t i = 0; i < nPi; ++i)
+         if(piWords[i].bit(0)) for(size_t k = bit; k < SimWord::BITS; ++k) piWords[i].setBit(k);
+      lastPatterns = bit;
+      ++nBlocks;
+   }
+   if(nBlocks)
+   {
+      simulateBlocks(blocks, nBlocks, lastPatterns);
+      patternNum += (nBlocks - 1) * SimWord::BITS + lastPatterns;
+   }
+   // wall-clock time, so reading the file counts as well
+   double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+   sortFEC();
+   printFEC();
+   cout << patternNum << " patterns simulated." << endl;
+   if(patternNum && sec > 0) cout << "Throughput: " << size_t(patternNum / sec) << " patterns/sec" << endl;
 }
 
 /*************************************************/
 /*   Private member functions about Simulation   */
 /*************************************************/
+// Flatten the netlist into _simView; _dfsList gives the topological order.
+// The view is dropped by updateDfsList() whenever the netlist changes.
+void
+CirMgr::buildSimView()
+{
+   _simView.init(sorted_list.size() - 1);
+   for(size_t i = 0, n = _piList.size(); i < n; ++i) _simView.addPi(_piList[i]->getId());
+   for(size_t i = 0, n = _dfsList.size(); i < n; ++i)
+   {
+      const CirGate* g = sorted_list[_dfsList[i]];
+      _simView.addAig(_dfsList[i], _simView.toLit(g->getIn(0)->getId(), g->fanin_inv(0)),
+                      _simView.toLit(g->getIn(1)->getId(), g->fanin_inv(1)));
+   }
+   for(size_t i = 0, n = _poList.size(); i < n; ++i)
+      _simView.addPo(_simView.toLit(_poList[i]->getIn(0)->getId(), _poList[i]->fanin_inv(0)));
+}
+
+// Split every FEC group by the signatures in "v" (one value per view index).
+bool
+CirMgr::refineFEC(const SimWord* v)
+{
+   return refineFEC(vector<const SimWord*>(1, v));
+}
+
+// Split every FEC group by the signatures in all the blocks, as if they were
+// one long signature. Before the first call all AIGs in _dfsList and CONST 0
+// are one candidate group. A member is stored as (gate id << 1 | phase),
+// where the phase tells whether its signature was complemented; singletons
+// are dropped at once, so the work per call is proportional to the surviving
+// candidates. The groups are dealt out to the pool in ranges of about the
+// same number of members, and the new groups keep the serial order.
+// Return true if any group was split.
+bool
+CirMgr::refineFEC(const vector<const SimWord*>& blocks)
+{
+   bool split = false;
+   if(!_fecInit)
+   {
+      split = true;
+      _fecInit = true;
+      _fecGrps.clear();
+      IdList all(1, 0);
+      for(size_t i = 0, n = _dfsList.size(); i < n; ++i) all.push_back(_dfsList[i] << 1);
+      if(all.size() > 1) _fecGrps.push_back(all);
+   }
+   size_t ng = _fecGrps.size(), nJobs = std::min(_pool.size(), ng);
+   if(nJobs == 0) return split;
+   // job t takes groups first[t] ~ first[t+1]-1
+   size_t members = 0;
+   for(size_t g = 0; g < ng; ++g) members += _fecGrps[g].size();
+   vector<size_t> first(nJobs + 1, ng);
+   first[0] = 0;
+   for(size_t g = 0, t = 1, sum = 0; g < ng && t < nJobs; ++g)
+   {
+      sum += _fecGrps[g].size();
+      if(sum * nJobs >= members * t) first[t++] = g + 1;
+   }
+   vector<vector<IdList> > out(nJobs);
+   vector<char> jobSplit(nJobs, 0);
+   _pool.run([&](size_t t) {
+      if(t >= nJobs) return;
+      for(size_t g = first[t]; g < first[t + 1]; ++g)
+         if(splitFECGroup(_fecGrps[g], blocks, _simView, out[t])) jobSplit[t] = 1;
+   });
+   vector<IdList> newGrps;
+   for(size_t t = 0; t < nJobs; ++t)
+   {
+      if(jobSplit[t]) split = true;
+      for(size_t i = 0, n = out[t].size(); i < n; ++i)
+      {
+         newGrps.push_back(IdList());
+         newGrps.back().swap(out[t][i]);
+      }
+   }
+   _fecGrps.swap(newGrps);
+   return split;
+}
+
+// members by gate id, groups by their smallest member
+static bool
+fecGrpLess(const IdList& a, const IdList& b) { return a[0] < b[0]; }
+
+void
+CirMgr::sortFEC()
+{
+   for(size_t i = 0, n = _fecGrps.size(); i < n; ++i) sort(_fecGrps[i].begin(), _fecGrps[i].end());
+   sort(_fecGrps.begin(), _fecGrps.end(), fecGrpLess);
+}
+
+// Simulate blocks 0 ~ n-1, whose PI values are set, on the pool (each block
+// is a private value array, see CirSimView::simulate(SimWord*)), refine the
+// FEC groups by all of them and log them in order; only the first
+// "lastPatterns" patterns of block n-1 are logged. The view keeps the PI
+// values of block n-1, which fraig() builds its counter-example words on.
+// Return true if any group was split.
+bool
+CirMgr::simulateBlocks(vector<vector<SimWord> >& blocks, size_t n, size_t lastPatterns)
+{
+   assert(n > 0 && n <= blocks.size());
+   size_t nThreads = _pool.size();
+   vector<string> logs(_simLog? n : 0);
+   _pool.run([&](size_t t) {
+      for(size_t b = t; b < n; b += nThreads)
+      {
+         _simView.simulate(&blocks[b][0]);
+         if(_simLog) writeSimLog(&blocks[b][0], (b + 1 == n)? lastPatterns : SimWord::BITS, logs[b]);
+      }
+   });
+   vector<const SimWord*> v(n);
+   for(size_t b = 0; b < n; ++b) v[b] = &blocks[b][0];
+   bool split = refineFEC(v);
+   for(size_t b = 0; b < logs.size(); ++b) (*_simLog) << logs[b];
+   for(size_t i = 0, m = _simView.numPi(); i < m; ++i) _simView.piValue(i) = blocks[n - 1][i + 1];
+   return split;
+}
+
+// one line per pattern: "<PI bits> <PO bits>", bit k of each SimWord is pattern k
+void
+CirMgr::writeSimLog(const SimWord* v, size_t patternNum, string& out) const
+{
+   size_t nPi = _simView.numPi(), nPo = _simView.numPo();
+   vector<SimWord> poValue(nPo);
+   for(size_t i = 0; i < nPo; ++i) poValue[i] = _simView.poValue(v, i);
+   string line(nPi + nPo + 2, ' ');
+   line[nPi + nPo + 1] = '\n';
+   out.clear();
+   out.reserve(patternNum * line.size());
+   for(size_t k = 0; k < patternNum; ++k)
+   {
+      for(size_t i = 0; i < nPi; ++i)
+         line[i] = v[i + 1].bit(k)? '1' : '0';
+      for(size_t i = 0; i < nPo; ++i)
+         line[nPi + 1 + i] = poValue[i].bit(k)? '1' : '0';
+      out += line;
+   }
+}
@@ -0,0 +1,107 @@
+/****************************************************************************
+  FileName     [ cirSimView.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the flat, levelized view of the AIG netlist ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_SIM_VIEW_H
+#define CIR_SIM_VIEW_H
+
+#include <vector>
+#include <cassert>
+#include "cirSimWord.h"
+
+using namespace std;
+
+//------------------------------------------------------------------------
+//   CirSimView
+//------------------------------------------------------------------------
+// A structure-of-arrays copy of the netlist for the hot loops
+// (simulation, FEC grouping, CNF generation).
+// Nodes are numbered by "index":
+//    0                     : CONST 0 (undefined gates are mapped here too)
+//    1 ~ numPi()           : PIs in file order
+//    firstAig() ~ size()-1 : AIGs in topological (_dfsList) order
+// Fanins are literals as in AIGER, i.e. (index << 1) | inverted,
+// so every fanin literal of an AIG refers to a smaller index.
+//
+class CirSimView
+{
+public:
+   CirSimView() : _numPi(0) {}
+
+   void clear() {
+      _numPi = 0;
+      _gateId.clear(); _index.clear(); _fanin0.clear(); _fanin1.clear();
+      _poLit.clear(); _value.clear();
+   }
+   // "maxId" is the largest gate id in the circuit
+   void init(size_t maxId) {
+      clear();
+      _index.assign(maxId + 1, 0);
+      _gateId.push_back(0);
+      _value.resize(1);
+   }
+   unsigned addPi(unsigned gid) {
+      assert(_fanin0.empty());
+      _index[gid] = _gateId.size(); _gateId.push_back(gid);
+      _value.resize(_gateId.size());
+      return ++_numPi;
+   }
+   unsigned addAig(unsigned gid, unsigned lit0, unsigned lit1) {
+      assert((lit0 >> 1) < _gateId.size() && (lit1 >> 1) < _gateId.size());
+      _index[gid] = _gateId.size(); _gateId.push_back(gid);
+      _fanin0.push_back(lit0); _fanin1.push_back(lit1);
+      _value.resize(_gateId.size());
+      return _index[gid];
+   }
+   void addPo(unsigned lit) { _poLit.push_back(lit); }
+
+   bool empty() const { return _gateId.empty(); }
+   size_t size() const { return _gateId.size(); }
+   size_t numPi() const { return _numPi; }
+   size_t numAig() const { return _fanin0.size(); }
+   size_t numPo() const { return _poLit.size(); }
+   unsigned firstAig() const { return _numPi + 1; }
+
+   // gate id <-> index
+   unsigned gateId(unsigned idx) const { return _gateId[idx]; }
+   unsigned index(unsigned gid) const { return _index[gid]; }
+   unsigned toLit(unsigned gid, bool inv) const { return (_index[gid] << 1) | unsigned(inv); }
+
+   unsigned fanin0(unsigned idx) const { return _fanin0[idx - firstAig()]; }
+   unsigned fanin1(unsigned idx) const { return _fanin1[idx - firstAig()]; }
+   unsigned poLit(size_t i) const { return _poLit[i]; }
+
+   // simulation values
+   SimWord& value(unsigned idx) { return _value[idx]; }
+   const SimWord& value(unsigned idx) const { return _value[idx]; }
+   SimWord& piValue(size_t i) { return _value[i + 1]; }
+   const SimWord& piValue(size_t i) const { return _value[i + 1]; }
+   SimWord poValue(size_t i) const { return poValue(&_value[0], i); }
+   SimWord poValue(const SimWord* v, size_t i) const { return SimWord::buf(v[_poLit[i] >> 1], _poLit[i] & 1); }
+
+   // PI values must be set before calling
+   void simulate() { simulate(&_value[0]); }
+   // simulate on a caller-owned value array of size(); the view itself is
+   // only read, so several threads may simulate their own arrays at once
+   void simulate(SimWord* v) const {
+      const unsigned* f0 = _fanin0.empty()? 0 : &_fanin0[0];
+      const unsigned* f1 = _fanin1.empty()? 0 : &_fanin1[0];
+      for(size_t k = 0, n = _fanin0.size(), idx = firstAig(); k < n; ++k, ++idx)
+         v[idx] = SimWord::aig(v[f0[k] >> 1], f0[k] & 1, v[f1[k] >> 1], f1[k] & 1);
+   }
+
+private:
+   size_t               _numPi;
+   vector<unsigned>     _gateId;    // index -> gate id
+   vector<unsigned>     _index;     // gate id -> index
+   vector<unsigned>     _fanin0;    // fanin literals of AIGs
+   vector<unsigned>     _fanin1;
+   vector<unsigned>     _poLit;     // fanin literals of POs
+   vector<SimWord>      _value;     // one simulation word per index
+};
+
+#endif // CIR_SIM_VIEW_H
@@ -0,0 +1,100 @@
+/****************************************************************************
+  FileName     [ cirSimWord.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the bit-parallel simulation word ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_SIM_WORD_H
+#define CIR_SIM_WORD_H
+
+#include <cstddef>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// Number of patterns simulated in one pass over the netlist.
+// Select with PKGFLAG in make.cir, e.g.
+//    PKGFLAG = -DSIM_WORD_BITS=256 -mavx2
+//    PKGFLAG = -DSIM_WORD_BITS=512 -mavx512f
+// Without the -m flags the portable loops below are used.
+#ifndef SIM_WORD_BITS
+#define SIM_WORD_BITS 64
+#endif
+
+#if SIM_WORD_BITS != 64 && SIM_WORD_BITS != 128 && SIM_WORD_BITS != 256 && SIM_WORD_BITS != 512
+#error "SIM_WORD_BITS must be 64, 128, 256 or 512"
+#endif
+
+//------------------------------------------------------------------------
+//   N x 64 patterns, bit k of the vector is pattern k
+//------------------------------------------------------------------------
+template <size_t N>
+class SimVec
+{
+public:
+   enum { WORDS = N, BITS = N * 64 };
+
+   SimVec() { for(size_t i = 0; i < N; ++i) _w[i] = 0; }
+
+   size_t& operator [] (size_t i) { return _w[i]; }
+   const size_t& operator [] (size_t i) const { return _w[i]; }
+
+   bool bit(size_t k) const { return (_w[k >> 6] >> (k & 63)) & 1; }
+   void setBit(size_t k) { _w[k >> 6] |= (size_t(1) << (k & 63)); }
+
+   SimVec operator ~ () const { SimVec v; for(size_t i = 0; i < N; ++i) v._w[i] = ~_w[i]; return v; }
+   bool operator == (const SimVec& v) const
+   {
+      for(size_t i = 0; i < N; ++i) if(_w[i] != v._w[i]) return false;
+      return true;
+   }
+   bool operator != (const SimVec& v) const { return !((*this) == v); }
+
+   // gate kernels; inv = true if the fanin is inverted
+   static SimVec buf(const SimVec& a, bool inva)
+   {
+      SimVec v; size_t ma = -size_t(inva);
+      for(size_t i = 0; i < N; ++i) v._w[i] = a._w[i] ^ ma;
+      return v;
+   }
+   static SimVec aig(const SimVec& a, bool inva, const SimVec& b, bool invb)
+   {
+      SimVec v; size_t ma = -size_t(inva), mb = -size_t(invb);
+#if defined(__AVX512F__)
+      if(N % 8 == 0)
+      {
+         __m512i xa = _mm512_set1_epi64(ma), xb = _mm512_set1_epi64(mb);
+         for(size_t i = 0; i < N; i += 8)
+            _mm512_storeu_si512((void*)(v._w + i), _mm512_and_si512(
+               _mm512_xor_si512(_mm512_loadu_si512((const void*)(a._w + i)), xa),
+               _mm512_xor_si512(_mm512_loadu_si512((const void*)(b._w + i)), xb)));
+         return v;
+      }
+#endif
+#if defined(__AVX2__)
+      if(N % 4 == 0)
+      {
+         __m256i xa = _mm256_set1_epi64x(ma), xb = _mm256_set1_epi64x(mb);
+         for(size_t i = 0; i < N; i += 4)
+            _mm256_storeu_si256((__m256i*)(v._w + i), _mm256_and_si256(
+               _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a._w + i)), xa),
+               _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(b._w + i)), xb)));
+         return v;
+      }
+#endif
+      for(size_t i = 0; i < N; ++i) v._w[i] = (a._w[i] ^ ma) & (b._w[i] ^ mb);
+      return v;
+   }
+
+private:
+   size_t _w[N];
+};
+
+typedef SimVec<SIM_WORD_BITS / 64>  SimWord;
+
+#endif // CIR_SIM_WORD_H
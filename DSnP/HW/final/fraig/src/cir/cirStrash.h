@@ -0,0 +1,124 @@
+/****************************************************************************
+  FileName     [ cirStrash.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the structural hash table of AIG gates ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_STRASH_H
+#define CIR_STRASH_H
+
+#include <vector>
+#include <climits>
+
+using namespace std;
+
+//------------------------------------------------------------------------
+//   CirStrashTable
+//------------------------------------------------------------------------
+// Maps the fanin literals (gate id << 1 | inverted) of an AIG gate to its
+// id. The pair is normalized so that a & b and b & a share one entry.
+// Open addressing with linear probing in a power-of-two array; erased
+// slots are left as tombstones until the next rehash.
+//
+class CirStrashTable
+{
+public:
+   CirStrashTable() : _used(0), _live(0) {}
+
+   void init(size_t n) {
+      size_t cap = 16;
+      while(cap < 2 * n) cap <<= 1;
+      _slots.assign(cap, Slot());
+      _used = _live = 0;
+   }
+   void clear() { _slots.clear(); _used = _live = 0; }
+   bool empty() const { return _slots.empty(); }
+   size_t size() const { return _live; }
+
+   bool query(unsigned lit0, unsigned lit1, unsigned& id) const {
+      if(_slots.empty()) return false;
+      normalize(lit0, lit1);
+      for(size_t i = bucket(lit0, lit1); ; i = (i + 1) & (_slots.size() - 1))
+      {
+         const Slot& s = _slots[i];
+         if(s._id == EMPTY) return false;
+         if(s._id != TOMB && s._lit0 == lit0 && s._lit1 == lit1) { id = s._id; return true; }
+      }
+   }
+   // Map (lit0, lit1) to "id", replacing the gate stored there if any
+   void replace(unsigned lit0, unsigned lit1, unsigned id) {
+      if(2 * (_used + 1) > _slots.size()) rehash();
+      normalize(lit0, lit1);
+      size_t tomb = _slots.size();
+      for(size_t i = bucket(lit0, lit1); ; i = (i + 1) & (_slots.size() - 1))
+      {
+         Slot& s = _slots[i];
+         if(s._id == EMPTY) {
+            if(tomb == _slots.size()) { tomb = i; ++_used; }
+            _slots[tomb] = Slot(lit0, lit1, id); ++_live;
+            return;
+         }
+         if(s._id == TOMB) { if(tomb == _slots.size()) tomb = i; continue; }
+         if(s._lit0 == lit0 && s._lit1 == lit1) { s._id = id; return; }
+      }
+   }
+   // Insert unless (lit0, lit1) is already there; return the gate it maps to
+   unsigned insert(unsigned lit0, unsigned lit1, unsigned id) {
+      unsigned old;
+      if(query(lit0, lit1, old)) return old;
+      replace(lit0, lit1, id);
+      return id;
+   }
+   // Erase (lit0, lit1) if it maps to "id"
+   void erase(unsigned lit0, unsigned lit1, unsigned id) {
+      if(_slots.empty()) return;
+      normalize(lit0, lit1);
+      for(size_t i = bucket(lit0, lit1); ; i = (i + 1) & (_slots.size() - 1))
+      {
+         Slot& s = _slots[i];
+         if(s._id == EMPTY) return;
+         if(s._id != TOMB && s._lit0 == lit0 && s._lit1 == lit1) {
+            if(s._id == id) { s._id = TOMB; --_live; }
+            return;
+         }
+      }
+   }
+
+private:
+   enum { EMPTY = UINT_MAX, TOMB = UINT_MAX - 1 };
+   struct Slot {
+      Slot(unsigned l0 = 0, unsigned l1 = 0, unsigned id = EMPTY) : _lit0(l0), _lit1(l1), _id(id) {}
+      unsigned _lit0, _lit1, _id;
+   };
+   vector<Slot>   _slots;
+   size_t         _used;   // slots that are not EMPTY (live + tombstones)
+   size_t         _live;
+
+   static void normalize(unsigned& lit0, unsigned& lit1) {
+      if(lit0 > lit1) { unsigned t = lit0; lit0 = lit1; lit1 = t; }
+   }
+   // the finalizer of splitmix64; ids are dense, so the low bits of the
+   // plain key would put neighbouring gates into neighbouring slots
+   size_t bucket(unsigned lit0, unsigned lit1) const {
+      unsigned long long k = ((unsigned long long)lit0 << 32) | lit1;
+      k ^= k >> 30; k *= 0xbf58476d1ce4e5b9ULL;
+      k ^= k >> 27; k *= 0x94d049bb133111ebULL;
+      k ^= k >> 31;
+      return size_t(k) & (_slots.size() - 1);
+   }
+   // grow only if most slots hold live gates, otherwise just drop tombstones
+   void rehash() {
+      vector<Slot> old;
+      old.swap(_slots);
+      size_t cap = (old.size())? old.size() : 16;
+      while(cap < 4 * (_live + 1)) cap <<= 1;
+      _slots.assign(cap, Slot());
+      _used = _live = 0;
+      for(size_t i = 0; i < old.size(); ++i)
+         if(old[i]._id != EMPTY && old[i]._id != TOMB) replace(old[i]._lit0, old[i]._lit1, old[i]._id);
+   }
+};
+
+#endif // CIR_STRASH_H
@@ -0,0 +1,90 @@
+/****************************************************************************
+  FileName     [ cirThreadPool.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the worker threads shared by simulation and fraig ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_THREAD_POOL_H
+#define CIR_THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+//------------------------------------------------------------------------
+//   CirThreadPool
+//------------------------------------------------------------------------
+// size() - 1 worker threads that stay alive between jobs, so a command
+// that runs many short rounds does not create and join threads for each.
+// run(job) calls job(t) for t = 0 ~ size()-1, t = 0 on the calling thread,
+// and returns when every call has returned.
+//
+class CirThreadPool
+{
+public:
+   CirThreadPool() : _job(0), _round(0), _busy(0), _stop(false) {}
+   ~CirThreadPool() { resize(1); }
+
+   size_t size() const { return _threads.size() + 1; }
+   // the threads are only restarted if the size changes
+   void resize(size_t n) {
+      if(n < 1) n = 1;
+      if(n == size()) return;
+      {
+         lock_guard<mutex> lock(_mutex);
+         _stop = true;
+      }
+      _start.notify_all();
+      for(size_t t = 0; t < _threads.size(); ++t) _threads[t].join();
+      _threads.clear();
+      _stop = false;
+      for(size_t t = 1; t < n; ++t) _threads.push_back(thread(&CirThreadPool::work, this, t, _round));
+   }
+
+   void run(const function<void(size_t)>& job) {
+      if(_threads.empty()) { job(0); return; }
+      {
+         lock_guard<mutex> lock(_mutex);
+         _job = &job; _busy = _threads.size(); ++_round;
+      }
+      _start.notify_all();
+      job(0);
+      unique_lock<mutex> lock(_mutex);
+      _done.wait(lock, [this]() { return _busy == 0; });
+      _job = 0;
+   }
+
+private:
+   mutex                               _mutex;
+   condition_variable                  _start;
+   condition_variable                  _done;
+   const function<void(size_t)>*       _job;
+   size_t                              _round;  // number of jobs started
+   size_t                              _busy;   // threads still in the job
+   bool                                _stop;
+   vector<thread>                      _threads;
+
+   void work(size_t t, size_t round) {
+      while(true)
+      {
+         const function<void(size_t)>* job;
+         {
+            unique_lock<mutex> lock(_mutex);
+            _start.wait(lock, [this, round]() { return _stop || _round != round; });
+            if(_stop) return;
+            round = _round; job = _job;
+         }
+         (*job)(t);
+         lock_guard<mutex> lock(_mutex);
+         if(--_busy == 0) _done.notify_one();
+      }
+   }
+};
+
+#endif // CIR_THREAD_POOL_H
@@ -21,8 +21,6 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "Sort.h"
 #include <cmath>
 
-int effLimit = INT_MAX;
-
 //=================================================================================================
 // Helper functions:
 
@@ -758,6 +756,7 @@ void Solver::claRescaleActivity()
 |________________________________________________________________________________________________@*/
 bool Solver::solve(const vec<Lit>& assumps)
 {
+    budget_out = false;
     simplifyDB();
     if (!ok) return false;
 
@@ -765,6 +764,7 @@ bool Solver::solve(const vec<Lit>& assumps)
     double  nof_conflicts = 100;
     double  nof_learnts   = nClauses() / 3;
     lbool   status        = l_Undef;
+    int64   conflicts_end = stats.conflicts + conflict_budget;
 
     // Perform assumptions:
     root_level = assumps.size();
@@ -815,14 +815,15 @@ bool Solver::solve(const vec<Lit>& assumps)
                    progress_estimate*100);
             fflush(stdout);
         }
-        status = search((int)nof_conflicts, (int)nof_learnts, params);
+        int nof_search = (int)nof_conflicts;
+        if (conflict_budget >= 0){
+            if (stats.conflicts >= conflicts_end){
+                budget_out = true;
+                break; }
+            nof_search = (int)min((int64)nof_search, conflicts_end - stats.conflicts); }
+        status = search(nof_search, (int)nof_learnts, params);
         nof_conflicts *= 1.5;
         nof_learnts   *= 1.1;
-
-if ((int)stats.conflicts >= effLimit) {
-   cancelUntil(0);
-   return status == l_True;
-}
     }
     if (verbosity >= 1) {
         reportf("===========================================");
@@ -136,7 +136,9 @@ public:
              , expensive_ccmin  (2)
              , proof            (NULL)
              , verbosity        (0)
+             , conflict_budget  (-1)
              , progress_estimate(0)
+             , budget_out       (false)
              , conflict_id      (ClauseId_NULL)
              {
                 vec<Lit> dummy(2,lit_Undef);
@@ -175,6 +177,7 @@ public:
     int             expensive_ccmin;    // Controls conflict clause minimization. TRUE by default.
     Proof*          proof;              // Set this directly after constructing 'Solver' to enable proof logging. Initialized to NULL.
     int             verbosity;          // Verbosity level. 0=silent, 1=some progress report, 2=everything
+    int64           conflict_budget;    // Max. number of conflicts of one 'solve()' call; negative means no limit. Initialized to -1.
 
     // Problem specification:
     //
@@ -194,6 +197,7 @@ public:
     bool    solve() { vec<Lit> tmp; return solve(tmp); }
 
     double      progress_estimate;  // Set by 'search()'.
+    bool        budget_out;         // Set by 'solve()'. TRUE if it stopped at 'conflict_budget', i.e. its FALSE result means "unknown".
     vec<lbool>  model;              // If problem is satisfiable, this vector contains the model (if any).
     vec<Lit>    conflict;           // If problem is unsatisfiable under assumptions, this vector represent the conflict clause expressed in the assumptions.
     ClauseId    conflict_id;        // (In proof logging mode only.) ID for the clause 'conflict' (for proof traverseral). NOTE! The empty clause is always the last clause derived, but for conflicts under assumption, this is not necessarly true.
@@ -71,6 +71,11 @@ class SatSolver
          _assump.push(val? Lit(prop): ~Lit(prop));
       }
       bool assumpSolve() { return _solver->solve(_assump); }
+      // Conflict limit of each solve call (negative = no limit);
+      // set it after initialize()
+      void setConflictBudget(int64 n) { _solver->conflict_budget = n; }
+      // true if the last solve ran out of budget, so its result is unknown
+      bool budgetOut() const { return _solver->budget_out; }
 
       // For one time proof, use "solve"
       void assertProperty(Var prop, bool val) {